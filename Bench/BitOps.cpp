@@ -0,0 +1,124 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+/*
+   Times the bitwise operations on big operands with each limb kernel the
+   processor supports. The portable kernel is the plain loop BitField used
+   to have, so it is the baseline.
+
+   Usage: BitOps [bits [repeats]]
+*/
+
+#include "../Integer.hpp"
+#include "../Limbs.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace BigInt;
+
+static Integer randomBits (long bits, Unit & seed)
+ {
+    /*
+      Build the halves separately: shifting a Unit at a time onto one
+      number would be quadratic.
+    */
+   if (bits > 64)
+    {
+      long low = ((bits + 127) / 128) * 64;
+      Integer result (randomBits(bits - low, seed));
+
+      result <<= Integer((long long) low);
+      result |= randomBits(low, seed);
+      return result;
+    }
+
+   seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+   return Integer(seed >> (64 - bits)) | Integer(1LL);
+ }
+
+static double seconds (std::chrono::steady_clock::time_point start)
+ {
+   return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+ }
+
+int main (int argc, char ** argv)
+ {
+   long bits = (argc > 1) ? std::atol(argv[1]) : (1L << 20);
+   long repeats = (argc > 2) ? std::atol(argv[2]) : 2000;
+   Unit seed = 1;
+
+   Integer a (randomBits(bits, seed)), b (randomBits(bits - 1000, seed));
+   Integer r, sink;
+
+   std::printf("%ld bit operands, %ld repeats, microseconds per operation\n",
+      bits, repeats);
+   std::printf("%-10s %10s %10s %10s %10s %10s\n",
+      "kernel", "a & b", "a | b", "a ^ b", "~a", "a &= b");
+
+   for (int k = Limbs::PORTABLE; k <= Limbs::AVX512; k++)
+    {
+      if (!Limbs::hasKernel((Limbs::Kernel) k)) continue;
+      Limbs::useBitwiseKernel((Limbs::Kernel) k);
+
+      double t [5];
+      std::chrono::steady_clock::time_point start;
+
+      start = std::chrono::steady_clock::now();
+      for (long i = 0; i < repeats; i++) sink = a & b;
+      t[0] = seconds(start);
+
+      start = std::chrono::steady_clock::now();
+      for (long i = 0; i < repeats; i++) sink = a | b;
+      t[1] = seconds(start);
+
+      start = std::chrono::steady_clock::now();
+      for (long i = 0; i < repeats; i++) sink = a ^ b;
+      t[2] = seconds(start);
+
+      start = std::chrono::steady_clock::now();
+      for (long i = 0; i < repeats; i++) sink = ~a;
+      t[3] = seconds(start);
+
+       // In place: r owns its Data, so no new holder is made.
+      r = a | Integer(1LL);
+      start = std::chrono::steady_clock::now();
+      for (long i = 0; i < repeats; i++) r &= a;
+      t[4] = seconds(start);
+
+      std::printf("%-10s", Limbs::kernelName((Limbs::Kernel) k));
+      for (int i = 0; i < 5; i++)
+         std::printf(" %10.3f", t[i] * 1e6 / repeats);
+      std::printf("\n");
+    }
+
+   return 0;
+ }
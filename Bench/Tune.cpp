@@ -0,0 +1,199 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+/*
+   Finds where Integer should change algorithms on this machine, and
+   writes them out as a header for Integer.cpp to pick up.
+
+   Multiply and Square are the first size, in Units, at which one level of
+   Karatsuba beats long multiplication, and keeps beating it for the next
+   few sizes. Convert is whichever piece size makes toString() and
+   fromString() fastest. Division has nothing to cross over to yet, so
+   there's nothing to tune for it.
+
+   Usage: Tune [header]     (the default is ../Tuned.hpp)
+   Rebuild with the header in place for it to take effect.
+*/
+
+#include "../Integer.hpp"
+#include "../Limbs.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace BigInt;
+
+static Integer randomUnits (long units, Unit & seed)
+ {
+   std::vector<Unit> words (units);
+   Integer result;
+
+   for (long i = 0; i < units; i++)
+    {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      words[i] = seed;
+    }
+   words[units - 1] |= (Unit) 1 << 63;
+   return result.importBytes(&words[0], units, LEAST_SIGNIFICANT_FIRST,
+      sizeof(Unit));
+ }
+
+static double seconds (std::chrono::steady_clock::time_point start)
+ {
+   return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+ }
+
+ // The best of a few runs of enough products to take a while.
+static double timeProduct (const Integer & a, const Integer & b)
+ {
+   long units = a.bitLength() / 64 + 1;
+   long repeats = 4000000 / (units * units) + 1;
+   double best = 1e30, t;
+   Integer sink;
+
+   for (int run = 0; run < 5; run++)
+    {
+      std::chrono::steady_clock::time_point start =
+         std::chrono::steady_clock::now();
+      for (long i = 0; i < repeats; i++) sink = a * b;
+      t = seconds(start);
+      if (t < best) best = t;
+    }
+
+   return best;
+ }
+
+ /*
+   Both thresholds at once: square says which one this is for, and the
+   other one is left where it was.
+ */
+static long crossover (bool square)
+ {
+   Integer_Thresholds old = Integer::getThresholds(), basecase = old, split = old;
+   const long wins = 3;
+   long found = 0, streak = 0;
+   Unit seed = 12345;
+
+   for (long units = 8; units <= 1024; units += (units < 64) ? 2 : units / 16)
+    {
+      Integer a (randomUnits(units, seed)), b (randomUnits(units, seed));
+      const Integer & c = square ? a : b;
+      double slow, fast;
+
+      if (square) basecase.Square = units + 1, split.Square = units;
+      else basecase.Multiply = units + 1, split.Multiply = units;
+
+      Integer::setThresholds(basecase);
+      slow = timeProduct(a, c);
+      Integer::setThresholds(split);
+      fast = timeProduct(a, c);
+
+      if (fast < slow)
+       {
+         if (streak++ == 0) found = units;
+         if (streak == wins) break;
+       }
+      else streak = 0;
+    }
+   Integer::setThresholds(old);
+
+   return (streak == wins) ? found : 1024;
+ }
+
+static long convertCut (void)
+ {
+   Integer_Thresholds old = Integer::getThresholds(), now = old;
+   Unit seed = 54321;
+   Integer a (randomUnits(4000, seed)), back;
+   std::string text (a.toString());
+   long best = old.Convert;
+   double bestTime = 1e30;
+
+   for (long cut = 2; cut <= 128; cut *= 2)
+    {
+      double t = 1e30;
+
+      now.Convert = cut;
+      Integer::setThresholds(now);
+      for (int run = 0; run < 3; run++)
+       {
+         std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+         text = a.toString();
+         back.fromString(text);
+         double d = seconds(start);
+         if (d < t) t = d;
+       }
+      if (t < bestTime)
+       {
+         bestTime = t;
+         best = cut;
+       }
+    }
+   Integer::setThresholds(old);
+
+   return best;
+ }
+
+int main (int argc, char ** argv)
+ {
+   const char * name = (argc > 1) ? argv[1] : "../Tuned.hpp";
+   Integer_Thresholds found;
+   std::FILE * out;
+
+   Limbs::arithmeticKernel(); // Don't time picking it.
+
+   std::printf("Timing multiplication...\n");
+   found.Multiply = crossover(false);
+   std::printf("Timing squaring...\n");
+   found.Square = crossover(true);
+   std::printf("Timing radix conversion...\n");
+   found.Convert = convertCut();
+
+   std::printf("K_CUT %ld, SQR_CUT %ld, CONVERT_CUT %ld\n",
+      found.Multiply, found.Square, found.Convert);
+
+   out = std::fopen(name, "w");
+   if (out == NULL)
+    {
+      std::printf("Couldn't write %s\n", name);
+      return 1;
+    }
+   std::fprintf(out, "/* Made by Bench/Tune for Integer.cpp. */\n");
+   std::fprintf(out, "#define K_CUT %ld\n", found.Multiply);
+   std::fprintf(out, "#define SQR_CUT %ld\n", found.Square);
+   std::fprintf(out, "#define CONVERT_CUT %ld\n", found.Convert);
+   std::fclose(out);
+   std::printf("Wrote %s\n", name);
+
+   return 0;
+ }
@@ -0,0 +1,2 @@
+g++ -s -Wall -Wextra -O3 -o BitOps BitOps.cpp ../Integer.cpp ../BitField.cpp ../Limbs.cpp ../Parallel.cpp ../Stats.cpp ../Sieve.cpp -pthread
+g++ -s -Wall -Wextra -O3 -o Tune Tune.cpp ../Integer.cpp ../BitField.cpp ../Limbs.cpp ../Parallel.cpp ../Stats.cpp ../Sieve.cpp -pthread
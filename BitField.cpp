@@ -28,6 +28,10 @@ SUCH DAMAGE.
 */
 
 #include "BitField.hpp"
+#include "Limbs.hpp"
+#include "Stats.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 
 namespace BigInt
@@ -65,27 +69,103 @@ namespace BigInt
    #define NEXT_TYPE __int128__
 
 
+    /*
+      The Units we have new []'d, for the budget. These are shared by every
+      thread, as a number may be let go by a different thread than the one
+      that made it.
+    */
+   static std::atomic<long> Budget (0);
+   static std::atomic<long> Used (0);
+   static std::atomic<long> Peak (0);
+
+   const char * Budget_Exceeded::what (void) const noexcept
+    {
+      return "BigInt: Unit budget exceeded";
+    }
+
+   long BitField::getBudget (void) { return Budget; }
+   long BitField::setBudget (long units)
+    {
+      return (Budget = ((units < 0) ? 0 : units));
+    }
+   long BitField::inUse (void) { return Used; }
+   long BitField::peak (void) { return Peak; }
+   long BitField::resetPeak (void) { return Peak.exchange(Used); }
+
+    /*
+      Every Unit array we make comes from here, and goes back through
+      freeUnits(), so that it can be counted. The budget is checked before
+      anything is allocated, so that nothing needs undoing when it's over.
+    */
+   static Unit * newUnits (long count)
+    {
+      long budget = Budget.load(std::memory_order_relaxed);
+      long now = Used.fetch_add(count, std::memory_order_relaxed) + count;
+      long peak = Peak.load(std::memory_order_relaxed);
+      Unit * result;
+
+      if ((budget != 0) && (now > budget))
+       {
+         Used.fetch_sub(count, std::memory_order_relaxed);
+         throw Budget_Exceeded ();
+       }
+
+      try
+       {
+         result = new Unit [count];
+       }
+      catch (...)
+       {
+         Used.fetch_sub(count, std::memory_order_relaxed);
+         throw;
+       }
+
+      while ((now > peak) && !Peak.compare_exchange_weak(peak, now,
+         std::memory_order_relaxed)) ;
+
+      Stats::allocated(count * sizeof(Unit));
+      return result;
+    }
+
+   static void freeUnits (Unit * data, long count)
+    {
+      Used.fetch_sub(count, std::memory_order_relaxed);
+      delete [] data;
+    }
+
 
    BitField::BitHolder::BitHolder () :
-      Data (NULL), Length (0), Size (0), Refs(0) { }
+      Data (NULL), Length (0), Size (0), Refs(0), Release (NULL), Owner (NULL)
+      { }
 
    BitField::BitHolder::BitHolder (const BitHolder & src, long extra) :
-      Data (NULL), Length (0), Size (0), Refs (1)
+      Data (NULL), Length (0), Size (0), Refs (1), Release (NULL), Owner (NULL)
     {
-         Data = new Unit [src.Length + extra];
+         Data = newUnits(src.Length + extra);
          Length = src.Length;
          Size = src.Length + extra;
 
          std::memcpy(Data, src.Data, Length * sizeof(Unit));
     }
 
+    /*
+      An uninitialized holder, for when the caller is about to write every
+      Unit of it anyway.
+    */
+   BitField::BitHolder::BitHolder (long length) :
+      Data (NULL), Length (length), Size (length), Refs (1),
+      Release (NULL), Owner (NULL)
+    {
+         Data = newUnits(length);
+    }
+
    BitField::BitHolder::~BitHolder ()
     {
        /*
          Alot of finalization is added before deallocation in case we need
          to hunt down bugs.
        */
-      if (Data != NULL) delete [] Data;
+      release();
 
       Data = NULL;
       Length = 0;
@@ -93,28 +173,62 @@ namespace BigInt
       Refs = 0;
     }
 
+    /*
+      Let go of the Units. Usually we new []'d them, but they may belong to
+      someone else, who gave us a function to call when we are done.
+    */
+   void BitField::BitHolder::release (void)
+    {
+      if (Release != NULL) Release(Owner);
+      else if (Data != NULL) freeUnits(Data, Size);
+
+      Data = NULL;
+      Release = NULL;
+      Owner = NULL;
+    }
+
 
 
-   BitField::BitField () : Data (NULL), Zero (true) { }
+   BitField::BitField () : Data (NULL), Zero (true), Offset (0) { }
 
-   BitField::BitField (Unit src) : Data (NULL), Zero (true)
+   BitField::BitField (Unit src) : Data (NULL), Zero (true), Offset (0)
     {
       if (src != 0)
+       {
+         Data = new BitHolder (1);
+         Data->Data[0] = src;
+         Zero = false;
+       }
+    }
+
+    /*
+      Wrap Units we didn't allocate. They must stay valid until release is
+      called with owner, and they must be writable: if we are the only
+      BitField using them, we may change them in place. A private, writable
+      memory mapping of a file is the intended case. The top Unit must not
+      be zero.
+    */
+   BitField::BitField (Unit * data, long length,
+      void (*release) (void *), void * owner) :
+      Data (NULL), Zero (true), Offset (0)
+    {
+      if (length > 0)
        {
          Zero = false;
          Data = new BitHolder;
 
-         Data->Data = new Unit [1];
-         Data->Length = 1;
-         Data->Size = 1;
+         Data->Data = data;
+         Data->Length = length;
+         Data->Size = length;
          Data->Refs = 1;
-
-         Data->Data[0] = src;
+         Data->Release = release;
+         Data->Owner = owner;
        }
+      else if (release != NULL) release(owner);
     }
 
    BitField::BitField (const BitField & src) :
-       Data (NULL), Zero (src.Zero)
+       Data (NULL), Zero (src.Zero), Offset (src.Offset)
     {
       if (!src.isZero())
        {
@@ -139,6 +253,42 @@ namespace BigInt
 
 
 
+    /*
+      Lower our Offset to "to", writing out the zero Units in between.
+      If we own Data and it has room, they're made in place.
+    */
+   void BitField::lower (long to)
+    {
+      if (Zero || (Offset <= to)) return;
+
+      long added = Offset - to;
+      BitHolder * tmp = NULL;
+
+      if ((Data->Refs == 1) && (Data->Size >= Data->Length + added))
+       {
+         std::memmove(Data->Data + added, Data->Data,
+            Data->Length * sizeof(Unit));
+       }
+      else
+       {
+         tmp = new BitHolder (Data->Length + added);
+         std::memcpy(tmp->Data + added, Data->Data,
+            Data->Length * sizeof(Unit));
+         tmp->Length = Data->Length;
+
+         Data->Refs--;
+         if (Data->Refs == 0) delete Data;
+         Data = tmp;
+         tmp = NULL;
+       }
+
+      std::memset(Data->Data, '\0', added * sizeof(Unit));
+      Data->Length += added;
+      Offset = to;
+    }
+
+
+
     /*
       Note that neither this nor >>= support negative amounts.
     */
@@ -153,14 +303,24 @@ namespace BigInt
        /* Are we essentially doing nothing? */
       if (Zero || (amount == 0)) return;
 
+       /*
+         Whole Units just go on the Offset. What's left is less than a
+         Unit, which we have to actually do.
+       */
+      Offset += addedUnits;
+      addedUnits = 0;
+      if (shiftAmount == 0) return;
+
        /*
          As BitField is composed of only mutator methods, one of the first
          things we do is make sure we "own" the Data that we are mutating.
        */
       if (Data->Refs != 1)
        {
+         Stats::detached();
+         BitHolder * tmp = new BitHolder (*Data, addedUnits + 1);
          Data->Refs--;
-         Data = new BitHolder (*Data, addedUnits + 1);
+         Data = tmp;
        }
 
        /*
@@ -182,14 +342,14 @@ namespace BigInt
          newLength = Data->Length + addedUnits + (carry == 0 ? 0 : 1);
          if (newLength > Data->Size)
           {
-            newData = new Unit [newLength];
+            newData = newUnits(newLength);
 
             std::memcpy(newData + addedUnits, Data->Data,
                Data->Length * sizeof(Unit));
             if (addedUnits != 0)
                std::memset(newData, '\0', addedUnits * sizeof(Unit));
 
-            delete [] Data->Data;
+            Data->release();
             Data->Data = newData;
             newData = NULL;
 
@@ -219,6 +379,23 @@ namespace BigInt
 
       if ((Zero) || (amount == 0)) return;
 
+       /*
+         Take whole Units off of the Offset first. If we then still need
+         to shift bits, they shift into the Unit below, so we need that.
+       */
+      if (lessUnits <= Offset)
+       {
+         Offset -= lessUnits;
+         lessUnits = 0;
+       }
+      else
+       {
+         lessUnits -= Offset;
+         Offset = 0;
+       }
+      if ((lessUnits == 0) && (shiftAmount == 0)) return;
+      if (Offset != 0) lower(Offset - 1);
+
        /* Are we just making ourself Zero? */
       if (lessUnits >= Data->Length)
        {
@@ -232,8 +409,10 @@ namespace BigInt
 
       if (Data->Refs != 1)
        {
+         Stats::detached();
+         BitHolder * tmp = new BitHolder (*Data);
          Data->Refs--;
-         Data = new BitHolder (*Data);
+         Data = tmp;
        }
 
       if (lessUnits != 0)
@@ -283,6 +462,7 @@ namespace BigInt
       Data = src.Data;
       src.Data->Refs++;
       Zero = false;
+      Offset = src.Offset;
     }
 
 
@@ -297,28 +477,41 @@ namespace BigInt
          Integer should never raise the error condition, so don't do it.
        */
 
-      Unit carry = 0;
-      NEXT_TYPE temp;
-      long i;
+      Unit carry;
+      long i, length = rhs.Data->Length, at;
+      BitHolder * tmp = NULL;
 
+       /*
+         The Units of rhs start "at" Units into our Data. If rhs starts
+         below us, the difference does too, so we need those Units.
+       */
+      if (rhs.Offset < Offset) lower(rhs.Offset);
+      at = rhs.Offset - Offset;
+
+       /*
+         If we share Data, subtract into a new holder: the kernels can
+         read one array and write another as easily as update in place.
+       */
       if (Data->Refs != 1)
        {
-         Data->Refs--;
-         Data = new BitHolder (*Data);
-       }
+         Stats::detached();
+         tmp = new BitHolder (Data->Length);
+         std::memcpy(tmp->Data, Data->Data, at * sizeof(Unit));
+         carry = Limbs::subN(tmp->Data + at, Data->Data + at,
+            rhs.Data->Data, length);
+         Limbs::sub1(tmp->Data + at + length, Data->Data + at + length,
+            Data->Length - at - length, carry);
 
-      for (i = 0; i < rhs.Data->Length; i++)
-       {
-         temp = (NEXT_TYPE)Data->Data[i] - rhs.Data->Data[i] - carry;
-         Data->Data[i] = (Unit)(temp & mask);
-         carry = (Unit)(temp >> bits) & (Unit)1; // Borrow out is at most 1
+         Data->Refs--;
+         Data = tmp;
+         tmp = NULL;
        }
-
-      for (; (i < Data->Length) && (carry != 0); i++)
+      else
        {
-         temp = (NEXT_TYPE)Data->Data[i] - carry;
-         Data->Data[i] = (Unit)(temp & mask);
-         carry = (Unit)(temp >> bits) & (Unit)1;
+         carry = Limbs::subN(Data->Data + at, Data->Data + at,
+            rhs.Data->Data, length);
+         Limbs::sub1(Data->Data + at + length, Data->Data + at + length,
+            Data->Length - at - length, carry);
        }
 
       if (Data->Data[Data->Length - 1] == 0)
@@ -336,6 +529,46 @@ namespace BigInt
        }
     }
 
+    /*
+      r = (a shifted up aPos Units) + (b shifted up bPos Units), over as
+      many Units as the longer one reaches, returning the carry out. One of
+      aPos or bPos is zero. r may be a if aPos is zero.
+    */
+   static Unit addAt (Unit * r, const Unit * a, long aPos, long aLength,
+      const Unit * b, long bPos, long bLength)
+    {
+      Unit carry;
+      long aEnd, bEnd, overlap;
+
+      if (bPos < aPos)
+       {
+         const Unit * t = a; a = b; b = t;
+         long tl = aLength; aLength = bLength; bLength = tl;
+         bPos = aPos;
+       }
+
+      aEnd = aLength;
+      bEnd = bPos + bLength;
+
+       // Under b, there's only a.
+      if (r != a)
+         std::memcpy(r, a, ((bPos < aEnd) ? bPos : aEnd) * sizeof(Unit));
+
+      if (bPos >= aEnd) // They don't even overlap.
+       {
+         std::memset(r + aEnd, '\0', (bPos - aEnd) * sizeof(Unit));
+         std::memcpy(r + bPos, b, bLength * sizeof(Unit));
+         return 0;
+       }
+
+      overlap = ((aEnd < bEnd) ? aEnd : bEnd) - bPos;
+      carry = Limbs::addN(r + bPos, a + bPos, b, overlap);
+
+      if (aEnd > bEnd)
+         return Limbs::add1(r + bEnd, a + bEnd, aEnd - bEnd, carry);
+      return Limbs::add1(r + aEnd, b + overlap, bEnd - aEnd, carry);
+    }
+
    void BitField::operator += (const BitField & rhs)
     {
       if (rhs.isZero()) return; //Simple case 1: we are adding zero
@@ -344,62 +577,54 @@ namespace BigInt
          Data = rhs.Data;
          Data->Refs++;
          Zero = false;
+         Offset = rhs.Offset;
          return;
        }
 
       Unit * newData = NULL, carry = 0;
-      NEXT_TYPE temp;
-      long i;
-      BitHolder * tmp = NULL, * Rhs = NULL;
-      bool freeRhs = false;
-
-      Rhs = rhs.Data;
+      BitHolder * tmp = NULL, * Rhs = rhs.Data;
 
        /*
-         For simplicity's sake, we add the smaller number to the larger.
-         This may require us to clone the larger, which we'd have to do
-         anyway, but with more complex logic.
+         The sum starts at the lower Offset. Place both numbers relative
+         to that, and see how far up the sum goes before any carry.
        */
-      if (Data->Length < Rhs->Length)
-       {
-         tmp = Data;
-         Data = Rhs;
-         Rhs = tmp;
-         tmp = NULL;
+      long low = (Offset < rhs.Offset) ? Offset : rhs.Offset;
+      long at = Offset - low, rhsAt = rhs.Offset - low;
+      long length = at + Data->Length;
 
-         freeRhs = true;
-         Data->Refs++;
-       }
+      if (rhsAt + Rhs->Length > length) length = rhsAt + Rhs->Length;
 
-      if (Data->Refs != 1)
+      if ((Data->Refs == 1) && (at == 0) && (Data->Size >= length))
        {
-         Data->Refs--;
-         Data = new BitHolder (*Data, 1);
+         carry = addAt(Data->Data, Data->Data, 0, Data->Length,
+            Rhs->Data, rhsAt, Rhs->Length);
+         Data->Length = length;
        }
-
-      for (i = 0; i < Rhs->Length; i++)
+      else
        {
-         temp = (NEXT_TYPE)Data->Data[i] + Rhs->Data[i] + carry;
-         Data->Data[i] = (Unit)(temp & mask);
-         carry = (Unit)(temp >> bits);
-       }
+          // Anticipate the carry, and add straight into the new holder.
+         tmp = new BitHolder (length + 1);
+         tmp->Length = length;
 
-      for (; (i < Data->Length) && (carry != 0); i++)
-       {
-         temp = (NEXT_TYPE)Data->Data[i] + carry;
-         Data->Data[i] = (Unit)(temp & mask);
-         carry = (Unit)(temp >> bits);
+         carry = addAt(tmp->Data, Data->Data, at, Data->Length,
+            Rhs->Data, rhsAt, Rhs->Length);
+
+         Data->Refs--;
+         if (Data->Refs == 0) delete Data;
+         Data = tmp;
+         tmp = NULL;
        }
+      Offset = low;
 
       if (carry != 0)
        {
          if ((Data->Length + 1) > Data->Size)
           {
-            newData = new Unit [Data->Length + 1];
+            newData = newUnits(Data->Length + 1);
 
             std::memcpy(newData, Data->Data, Data->Length * sizeof(Unit));
 
-            delete [] Data->Data;
+            Data->release();
             Data->Data = newData;
             newData = NULL;
 
@@ -409,13 +634,6 @@ namespace BigInt
          Data->Data[Data->Length] = carry;
          Data->Length++;
        }
-
-      if (freeRhs)
-       {
-         Rhs->Refs--;
-         if (Rhs->Refs == 0) delete Rhs;
-       }
-      Rhs = NULL;
     }
 
    void BitField::operator &= (const BitField & rhs)
@@ -431,7 +649,20 @@ namespace BigInt
          return;
        }
 
-      long i;
+       /*
+         The bitwise operations don't bother with Offsets.
+       */
+      if ((Offset != 0) || (rhs.Offset != 0))
+       {
+         BitField flat (rhs);
+
+         lower(0);
+         flat.lower(0);
+         *this &= flat;
+         return;
+       }
+
+      long i, length;
       BitHolder * tmp = NULL, * Rhs = NULL;
       bool freeRhs = false;
 
@@ -452,20 +683,28 @@ namespace BigInt
          Data->Refs++;
        }
 
+      length = (Data->Length > Rhs->Length) ? Rhs->Length : Data->Length;
+
+       /*
+         If we don't own Data, AND into a new holder rather than copying
+         Data and then ANDing the copy: one pass over memory, not two.
+       */
       if (Data->Refs != 1)
        {
+         Stats::detached();
+         tmp = new BitHolder (length);
+         Limbs::andN(tmp->Data, Data->Data, Rhs->Data, length);
+
          Data->Refs--;
-         Data = new BitHolder (*Data);
+         Data = tmp;
+         tmp = NULL;
        }
-
-      if (Data->Length > Rhs->Length)
+      else
        {
-         Data->Length = Rhs->Length;
+         Limbs::andN(Data->Data, Data->Data, Rhs->Data, length);
+         Data->Length = length;
        }
 
-      for (i = 0; i < Data->Length; i++)
-         Data->Data[i] &= Rhs->Data[i];
-
        /*
          Handle cancellation.
        */
@@ -499,10 +738,23 @@ namespace BigInt
          Data = rhs.Data;
          Data->Refs++;
          Zero = false;
+         Offset = rhs.Offset;
+         return;
+       }
+
+       /*
+         The bitwise operations don't bother with Offsets.
+       */
+      if ((Offset != 0) || (rhs.Offset != 0))
+       {
+         BitField flat (rhs);
+
+         lower(0);
+         flat.lower(0);
+         *this |= flat;
          return;
        }
 
-      long i;
       BitHolder * tmp = NULL, * Rhs = NULL;
       bool freeRhs = false;
 
@@ -524,12 +776,18 @@ namespace BigInt
 
       if (Data->Refs != 1)
        {
+         Stats::detached();
+         tmp = new BitHolder (Data->Length);
+         Limbs::iorN(tmp->Data, Data->Data, Rhs->Data, Rhs->Length);
+         std::memcpy(tmp->Data + Rhs->Length, Data->Data + Rhs->Length,
+            (Data->Length - Rhs->Length) * sizeof(Unit));
+
          Data->Refs--;
-         Data = new BitHolder (*Data);
+         Data = tmp;
+         tmp = NULL;
        }
-
-      for (i = 0; i < Rhs->Length; i++)
-         Data->Data[i] |= Rhs->Data[i];
+      else
+         Limbs::iorN(Data->Data, Data->Data, Rhs->Data, Rhs->Length);
 
        /*
          OR neither cancels, nor increases a number's size.
@@ -550,6 +808,20 @@ namespace BigInt
          Data = rhs.Data;
          Data->Refs++;
          Zero = false;
+         Offset = rhs.Offset;
+         return;
+       }
+
+       /*
+         The bitwise operations don't bother with Offsets.
+       */
+      if ((Offset != 0) || (rhs.Offset != 0))
+       {
+         BitField flat (rhs);
+
+         lower(0);
+         flat.lower(0);
+         *this ^= flat;
          return;
        }
 
@@ -575,12 +847,18 @@ namespace BigInt
 
       if (Data->Refs != 1)
        {
+         Stats::detached();
+         tmp = new BitHolder (Data->Length);
+         Limbs::xorN(tmp->Data, Data->Data, Rhs->Data, Rhs->Length);
+         std::memcpy(tmp->Data + Rhs->Length, Data->Data + Rhs->Length,
+            (Data->Length - Rhs->Length) * sizeof(Unit));
+
          Data->Refs--;
-         Data = new BitHolder (*Data);
+         Data = tmp;
+         tmp = NULL;
        }
-
-      for (i = 0; i < Rhs->Length; i++)
-         Data->Data[i] ^= Rhs->Data[i];
+      else
+         Limbs::xorN(Data->Data, Data->Data, Rhs->Data, Rhs->Length);
 
        /*
          Handle cancellation,
@@ -614,21 +892,18 @@ namespace BigInt
     {
       if (carry == 0) return;
 
-      NEXT_TYPE temp;
       long i;
 
+      lower(0);
       if (Data->Refs != 1)
        {
+         Stats::detached();
+         BitHolder * tmp = new BitHolder (*Data);
          Data->Refs--;
-         Data = new BitHolder (*Data);
+         Data = tmp;
        }
 
-      for (i = 0; (i < Data->Length) && (carry != 0); i++)
-       {
-         temp = (NEXT_TYPE)Data->Data[i] - carry;
-         Data->Data[i] = (Unit)(temp & mask);
-         carry = (Unit)(temp >> bits) & (Unit)1;
-       }
+      Limbs::sub1(Data->Data, Data->Data, Data->Length, carry);
 
       if (Data->Data[Data->Length - 1] == 0)
        {
@@ -650,44 +925,35 @@ namespace BigInt
       if (carry == 0) return;
 
       Unit * newData = NULL;
-      NEXT_TYPE temp;
-      long i;
 
       if (Zero)
        {
-         Zero = false;
-         Data = new BitHolder;
-
-         Data->Data = new Unit [1];
-         Data->Length = 1;
-         Data->Size = 1;
-         Data->Refs = 1;
-
+         Data = new BitHolder (1);
          Data->Data[0] = carry;
+         Zero = false;
+         Offset = 0;
          return;
        }
+      lower(0);
       if (Data->Refs != 1)
        {
+         Stats::detached();
+         BitHolder * tmp = new BitHolder (*Data, 1);
          Data->Refs--;
-         Data = new BitHolder (*Data, 1);
+         Data = tmp;
        }
 
-      for (i = 0; (i < Data->Length) && (carry != 0); i++)
-       {
-         temp = (NEXT_TYPE)Data->Data[i] + carry;
-         Data->Data[i] = (Unit)(temp & mask);
-         carry = (Unit)(temp >> bits);
-       }
+      carry = Limbs::add1(Data->Data, Data->Data, Data->Length, carry);
 
       if (carry != 0)
        {
          if ((Data->Length + 1) > Data->Size)
           {
-            newData = new Unit [Data->Length + 1];
+            newData = newUnits(Data->Length + 1);
 
             std::memcpy(newData, Data->Data, Data->Length * sizeof(Unit));
 
-            delete [] Data->Data;
+            Data->release();
             Data->Data = newData;
             newData = NULL;
 
@@ -720,32 +986,32 @@ namespace BigInt
          return;
        }
 
-      Unit carry = 0, temp, * newData = NULL;
+      Unit carry, * newData = NULL;
+      BitHolder * tmp = NULL;
 
       if (Data->Refs != 1)
        {
-         Data->Refs--;
-         Data = new BitHolder (*Data, 1);
-       }
+         Stats::detached();
+         tmp = new BitHolder (Data->Length + 1);
+         tmp->Length = Data->Length;
+         carry = Limbs::mul1(tmp->Data, Data->Data, Data->Length, mult);
 
-      for (long i = 0; i < Data->Length; i++)
-       {
-         temp = Data->Data[i];
-         Data->Data[i] =
-            (Unit)((((unsigned NEXT_TYPE)temp * mult) + carry) & mask);
-         carry =
-            (Unit)((((unsigned NEXT_TYPE)temp * mult) + carry) >> bits);
+         Data->Refs--;
+         Data = tmp;
+         tmp = NULL;
        }
+      else
+         carry = Limbs::mul1(Data->Data, Data->Data, Data->Length, mult);
 
       if (carry != 0)
        {
          if ((Data->Length + 1) > Data->Size)
           {
-            newData = new Unit [Data->Length + 1];
+            newData = newUnits(Data->Length + 1);
 
             std::memcpy(newData, Data->Data, Data->Length * sizeof(Unit));
 
-            delete [] Data->Data;
+            Data->release();
             Data->Data = newData;
             newData = NULL;
 
@@ -757,6 +1023,39 @@ namespace BigInt
        }
     }
 
+    /*
+      Schoolbook multiplication: this = lhs * rhs. Either may be this.
+      Integer decides when something smarter is in order.
+    */
+   void BitField::multiply (const BitField & lhs, const BitField & rhs)
+    {
+      BitHolder * result = NULL;
+      long offset = 0;
+
+       // Multiplying by a power of the base is adding Offsets.
+      if (!lhs.isZero() && !rhs.isZero())
+       {
+         offset = lhs.Offset + rhs.Offset;
+         result = new BitHolder (lhs.Data->Length + rhs.Data->Length);
+         Limbs::mulBasecase(result->Data,
+            lhs.Data->Data, lhs.Data->Length,
+            rhs.Data->Data, rhs.Data->Length);
+
+          // The product of an n and an m Unit number has n + m - 1 or n + m.
+         if (result->Data[result->Length - 1] == 0) result->Length--;
+       }
+
+      if (!Zero)
+       {
+         Data->Refs--;
+         if (Data->Refs == 0) delete Data;
+       }
+
+      Data = result;
+      Zero = (result == NULL);
+      Offset = offset;
+    }
+
     /*
       This is a little wierd. We do the division, mutating the BitField,
       and return the remainder. This convention makes perfect sense in
@@ -769,10 +1068,14 @@ namespace BigInt
 
       Unit rem = 0, temp;
 
+      lower(0);
+
       if (Data->Refs != 1)
        {
+         Stats::detached();
+         BitHolder * tmp = new BitHolder (*Data);
          Data->Refs--;
-         Data = new BitHolder (*Data);
+         Data = tmp;
        }
 
       for (long i = Data->Length - 1; i >= 0; i--)
@@ -809,18 +1112,28 @@ namespace BigInt
 
       if (!Zero && rhs.isZero()) return 1;
 
-      if (Data->Length > rhs.Data->Length) return 1;
+      if (length() > rhs.length()) return 1;
 
-      if (Data->Length < rhs.Data->Length) return -1;
+      if (length() < rhs.length()) return -1;
 
-      long i;
-      for (i = Data->Length - 1;
-         (i >= 0) && (Data->Data[i] == rhs.Data->Data[i]); i--) ;
+       /*
+         Compare the Units we both have, then, if those are equal, whoever
+         has Units below where the other's Offset starts is bigger if any
+         of them aren't zero.
+       */
+      long i, low = (Offset > rhs.Offset) ? Offset : rhs.Offset;
+      for (i = length() - 1; (i >= low) &&
+         (Data->Data[i - Offset] == rhs.Data->Data[i - rhs.Offset]); i--) ;
+
+      if (i >= low)
+         return (Data->Data[i - Offset] > rhs.Data->Data[i - rhs.Offset]) ?
+            1 : -1;
 
-      if (i == -1) return 0;
+      for (; i >= Offset; i--) if (Data->Data[i - Offset] != 0) return 1;
+      for (; i >= rhs.Offset; i--)
+         if (rhs.Data->Data[i - rhs.Offset] != 0) return -1;
 
-      if (Data->Data[i] > rhs.Data->Data[i]) return 1;
-      return -1;
+      return 0;
     }
 
 
@@ -865,20 +1178,44 @@ namespace BigInt
     {
       if (Zero) return -1;
 
-      long result = Data->Length * bits - 1;
+       // The top Unit is never zero, so clz is defined.
+      return (Data->Length + Offset) * bits - 1 -
+         __builtin_clzll(Data->Data[Data->Length - 1]);
+    }
 
-      for (Unit i = (((Unit)1) << (bits - 1));
-           !(Data->Data[Data->Length - 1] & i);
-           i >>= 1, result--) ;
+   long BitField::lsb (void) const
+    {
+      if (Zero) return -1;
+
+      long i;
+      for (i = 0; Data->Data[i] == 0; i++) ; // Only the top is known non-zero.
+
+      return (i + Offset) * bits + __builtin_ctzll(Data->Data[i]);
+    }
+
+   long BitField::popcount (void) const
+    {
+      long result = 0;
+
+      if (!Zero)
+         for (long i = 0; i < Data->Length; i++)
+            result += __builtin_popcountll(Data->Data[i]);
 
       return result;
     }
 
+   bool BitField::testBit (long bit) const
+    {
+      if (Zero || (bit < 0)) return false;
+      return (getDigit(bit / bits) >> (bit % bits)) & 1;
+    }
+
 
 
    Unit BitField::getDigit (long index) const
     {
       if (Zero) return 0;
+      index -= Offset;
       if ((index < 0) || (index >= Data->Length)) return 0;
       return Data->Data[index];
     }
@@ -905,23 +1242,23 @@ namespace BigInt
          Risk generating a leading zero to ensure that a leading 1 isn't
          dropped.
        */
+      Unit top = getDigit(length() - 1), next = getDigit(length() - 2),
+         third = getDigit(length() - 3);
+
       if (shortGuess)
        {
-         approx = Data->Data[Data->Length - 1] / divisor;
+         approx = top / divisor;
          temp = approx;
 
-         rhs = (((unsigned NEXT_TYPE)Data->Data[Data->Length - 1] %
-            divisor) << bits) | Data->Data[Data->Length - 2];
+         rhs = (((unsigned NEXT_TYPE)top % divisor) << bits) | next;
        }
       else
        {
-         temp = (((unsigned NEXT_TYPE)Data->Data[Data->Length - 1] << bits) |
-            Data->Data[Data->Length - 2]) / divisor;
+         temp = (((unsigned NEXT_TYPE)top << bits) | next) / divisor;
          approx = (Unit)temp;
 
-         rhs = (((((unsigned NEXT_TYPE)Data->Data[Data->Length - 1] << bits) |
-            Data->Data[Data->Length - 2]) % divisor) << bits) |
-            Data->Data[Data->Length - 3];
+         rhs = (((((unsigned NEXT_TYPE)top << bits) | next) % divisor)
+            << bits) | third;
        }
 
       lhs = (unsigned NEXT_TYPE)approx * sec;
@@ -944,20 +1281,24 @@ namespace BigInt
       long i;
       Unit mask;
 
-      if (Data->Refs != 1)
-       {
-         Data->Refs--;
-         Data = new BitHolder (*Data);
-       }
+      lower(0);
 
        /*
          Only complement up to the msb.
        */
-      mask = 0;
-      while (mask < Data->Data[Data->Length - 1]) mask = (mask << 1) + 1;
+      mask = ~((Unit)0) >> __builtin_clzll(Data->Data[Data->Length - 1]);
 
-      for (i = 0; i < Data->Length; i++)
-         Data->Data[i] = ~Data->Data[i];
+      if (Data->Refs != 1)
+       {
+         Stats::detached();
+         BitHolder * tmp = new BitHolder (Data->Length);
+         Limbs::comN(tmp->Data, Data->Data, Data->Length);
+
+         Data->Refs--;
+         Data = tmp;
+       }
+      else
+         Limbs::comN(Data->Data, Data->Data, Data->Length);
 
       Data->Data[Data->Length - 1] &= mask;
 
@@ -984,6 +1325,17 @@ namespace BigInt
     /*
       Split the current BitField into two pieces.
     */
+   void BitField::unshare (void)
+    {
+      if (!Zero && (Data->Refs != 1))
+       {
+         Stats::detached();
+         BitHolder * tmp = new BitHolder (*Data);
+         Data->Refs--;
+         Data = tmp;
+       }
+    }
+
    void BitField::split (BitField & high, BitField & low, long at) const
     {
       if (!high.Zero) // Put the destinations into a known state.
@@ -1002,6 +1354,14 @@ namespace BigInt
        }
 
       if (Zero) return; // Do nothing more. This is probably an error.
+      if (Offset != 0)
+       {
+         BitField flat (*this);
+
+         flat.lower(0);
+         flat.split(high, low, at);
+         return;
+       }
       if (Data->Length <= at)
        {
          low = *this;
@@ -1015,29 +1375,241 @@ namespace BigInt
        }
       if (!zero)
        {
+         low.Data = new BitHolder (at);
          low.Zero = false;
-         low.Data = new BitHolder;
-
-         low.Data->Data = new Unit [at];
-         low.Data->Length = at;
-         low.Data->Size = at;
-         low.Data->Refs = 1;
+         low.Offset = 0;
 
          std::memcpy(low.Data->Data, Data->Data, at * sizeof(Unit));
          while (low.Data->Data[low.Data->Length - 1] == 0) low.Data->Length--;
        }
 
+      high.Data = new BitHolder (Data->Length - at);
       high.Zero = false;
-      high.Data = new BitHolder;
-
-      high.Data->Data = new Unit [Data->Length - at];
-      high.Data->Length = Data->Length - at;
-      high.Data->Size = Data->Length - at;
-      high.Data->Refs = 1;
+      high.Offset = 0;
 
       std::memcpy(high.Data->Data, Data->Data + at, (Data->Length - at) * sizeof(Unit));
     }
 
 
 
+    /*
+      Bit slices. These read and write up to a Unit's worth of bits, at
+      any offset, touching only the one or two Units involved. Bits past
+      the end of the number read as zero.
+    */
+   Unit BitField::getBits (long offset, int width) const
+    {
+      if (Zero || (width <= 0)) return 0;
+
+      long index = offset / bits;
+      int shift = offset % bits;
+      Unit result = getDigit(index) >> shift;
+
+      if ((shift != 0) && (shift + width > bits))
+         result |= getDigit(index + 1) << (bits - shift);
+
+      if (width < bits) result &= (((Unit)1) << width) - 1;
+
+      return result;
+    }
+
+    /*
+      Write the low width bits of value over the bits at offset. This only
+      copies if we share Data, and only reallocates if the slice is past
+      our end. When it does, it grows by half again, so that filling in a
+      number from the bottom up, a byte at a time, is linear.
+    */
+   void BitField::setBits (long offset, int width, Unit value)
+    {
+      if (width <= 0) return;
+      if (width < bits) value &= (((Unit)1) << width) - 1;
+
+      long index = offset / bits, i;
+      int shift = offset % bits;
+      long top = (offset + width - 1) / bits + 1; // Units needed to hold it
+      Unit field = (width < bits) ? ((((Unit)1) << width) - 1) : mask;
+      Unit * newData = NULL;
+
+       // Clearing bits we don't have is nothing.
+      if ((value == 0) && (index >= length())) return;
+
+      if (!Zero) lower(0);
+      if (Zero)
+       {
+         Data = new BitHolder (top);
+         Zero = false;
+         Offset = 0;
+         std::memset(Data->Data, '\0', top * sizeof(Unit));
+       }
+      else if (Data->Refs != 1)
+       {
+         Stats::detached();
+         BitHolder * tmp = new BitHolder (*Data,
+            (top > Data->Length) ? (top - Data->Length) : 0);
+         Data->Refs--;
+         Data = tmp;
+       }
+
+      if (top > Data->Length)
+       {
+         if (top > Data->Size)
+          {
+            long size = Data->Size + Data->Size / 2;
+            if (size < top) size = top;
+
+            newData = newUnits(size);
+            std::memcpy(newData, Data->Data, Data->Length * sizeof(Unit));
+
+            Data->release();
+            Data->Data = newData;
+            newData = NULL;
+
+            Data->Size = size;
+          }
+
+         std::memset(Data->Data + Data->Length, '\0',
+            (top - Data->Length) * sizeof(Unit));
+         Data->Length = top;
+       }
+
+      Data->Data[index] = (Data->Data[index] & ~(field << shift)) |
+         (value << shift);
+      if ((shift != 0) && (shift + width > bits))
+         Data->Data[index + 1] =
+            (Data->Data[index + 1] & ~(field >> (bits - shift))) |
+            (value >> (bits - shift));
+
+       /*
+         Handle cancellation.
+       */
+      if (Data->Data[Data->Length - 1] == 0)
+       {
+         for (i = Data->Length - 1; (i >= 0) && (Data->Data[i] == 0); i--) ;
+         Data->Length = i + 1;
+
+         if (i == -1) //Are we Zero?
+          {
+            delete Data;
+
+            Data = NULL;
+            Zero = true;
+          }
+       }
+    }
+
+    /*
+      A slice of any width, into dest, which had better not be this.
+    */
+   void BitField::getBits (BitField & dest, long offset, long width) const
+    {
+      if (!dest.Zero)
+       {
+         dest.Data->Refs--;
+         if (dest.Data->Refs == 0) delete dest.Data;
+         dest.Data = NULL;
+         dest.Zero = true;
+       }
+
+      if (Zero || (width <= 0) || (offset / bits >= length())) return;
+
+       // Don't allocate for bits we don't have.
+      if (offset + width > length() * bits)
+         width = length() * bits - offset;
+
+      long length = (width + bits - 1) / bits, i;
+
+      dest.Data = new BitHolder (length);
+      dest.Zero = false;
+      dest.Offset = 0;
+
+      for (i = 0; i < length; i++)
+         dest.Data->Data[i] = getBits(offset + i * bits,
+            (width - i * bits < bits) ? (int)(width - i * bits) : bits);
+
+      for (i = length - 1; (i >= 0) && (dest.Data->Data[i] == 0); i--) ;
+      dest.Data->Length = i + 1;
+
+      if (i == -1)
+       {
+         delete dest.Data;
+
+         dest.Data = NULL;
+         dest.Zero = true;
+       }
+    }
+
+
+
+    /*
+      The low bytes bytes of the number, little-endian, padded with zeros if
+      there aren't that many. On a little-endian machine, that's mostly a
+      copy.
+    */
+   void BitField::exportBytes (unsigned char * dest, long bytes) const
+    {
+      long at = 0, units, i;
+
+      if (!Zero)
+       {
+         at = std::min(bytes, Offset * (long) sizeof(Unit));
+         std::memset(dest, '\0', at);
+
+         units = std::min(Data->Length, (bytes - at) / (long) sizeof(Unit));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+         std::memcpy(dest + at, Data->Data, units * sizeof(Unit));
+         at += units * sizeof(Unit);
+#else
+         for (i = 0; i < units; i++)
+            for (int j = 0; j < (int) sizeof(Unit); j++)
+               dest[at++] = (unsigned char) (Data->Data[i] >> (8 * j));
+#endif
+
+          // A piece of the next Unit, if bytes ends inside it.
+         for (i = 0; (at < bytes) && (units < Data->Length) &&
+            (i < (long) sizeof(Unit)); i++)
+            dest[at++] = (unsigned char) (Data->Data[units] >> (8 * i));
+       }
+
+      std::memset(dest + at, '\0', bytes - at);
+    }
+
+   void BitField::importBytes (const unsigned char * src, long bytes)
+    {
+      long count;
+
+      if (!Zero)
+       {
+         Data->Refs--;
+         if (Data->Refs == 0) delete Data;
+
+         Data = NULL;
+         Zero = true;
+       }
+
+       // Leading zeros are legal, but we don't store them.
+      while ((bytes > 0) && (src[bytes - 1] == 0)) bytes--;
+      if (bytes == 0) return;
+
+      count = (bytes + sizeof(Unit) - 1) / sizeof(Unit);
+
+      Data = new BitHolder (count);
+      Zero = false;
+      Offset = 0;
+      Data->Data[count - 1] = 0;
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+      std::memcpy(Data->Data, src, bytes);
+#else
+      for (long i = 0; i < count - 1; i++)
+       {
+         Data->Data[i] = 0;
+         for (int j = (int) sizeof(Unit) - 1; j >= 0; j--)
+            Data->Data[i] = (Data->Data[i] << 8) | src[i * sizeof(Unit) + j];
+       }
+      for (long i = bytes - 1; i >= (count - 1) * (long) sizeof(Unit); i--)
+         Data->Data[count - 1] = (Data->Data[count - 1] << 8) | src[i];
+#endif
+    }
+
+
  } /* namespace BigInt */
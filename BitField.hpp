@@ -46,18 +46,36 @@ SUCH DAMAGE.
    bc_num in GNU bc, and implemented COW. This makes the numerous temporary
    variables created by C++ more efficient. BitHolder holds a non-zero number
    in an array that may be larger than necessary.
+
+   A BitField is its BitHolder shifted up by Offset whole Units, which are
+   implied zeros. This makes shifting by whole Units free, and as the Offset
+   isn't in the BitHolder, a shared BitHolder can be shifted without being
+   copied. Addition, subtraction, comparison and multiplication work with the
+   Offset; anything else lowers it to zero first.
 */
 
 #ifndef BITFIELD_HPP
 #define BITFIELD_HPP
 
 #include <cstdint>
+#include <new>
 
 namespace BigInt
  {
 
    typedef uint64_t Unit;
 
+    /*
+      Thrown instead of making a number that would put us over the budget
+      given to BitField::setBudget(). It's a std::bad_alloc, so whatever
+      copes with running out of memory copes with this too.
+    */
+   class Budget_Exceeded : public std::bad_alloc
+    {
+      public:
+         const char * what (void) const noexcept;
+    };
+
    class BitField
     {
 
@@ -71,18 +89,46 @@ namespace BigInt
                long Size;
                mutable long Refs;
 
+                // For Units that aren't ours to delete.
+               void (*Release) (void *);
+               void * Owner;
+
                BitHolder ();
                BitHolder (const BitHolder &, long extra = 0);
+               explicit BitHolder (long);
                ~BitHolder ();
+
+               void release (void);
           };
 
          BitHolder * Data;
          bool Zero;
+         long Offset; // Only meaningful if we aren't Zero.
+
+         void lower (long);
 
       public:
 
+          /*
+            A cap on the Units all BitFields in the process may hold at once,
+            with zero for none, which is the default. An operation that
+            would go over throws Budget_Exceeded. Its operands are left
+            alone, and the one it was changing in place, if any, is still a
+            valid number, but not necessarily the one it was.
+
+            inUse() and peak() are the Units held now, and the most ever held
+            since the last resetPeak(). resetPeak() returns the old peak.
+            Units belonging to someone else, as below, don't count.
+          */
+         static long getBudget (void);
+         static long setBudget (long);
+         static long inUse (void);
+         static long peak (void);
+         static long resetPeak (void);
+
          BitField ();
          BitField (Unit);
+         BitField (Unit *, long, void (*) (void *), void *);
          BitField (const BitField &);
 
          ~BitField ();
@@ -102,13 +148,18 @@ namespace BigInt
          void operator *= (Unit);
          Unit operator /= (Unit);
 
+         void multiply (const BitField &, const BitField &);
+
          void operator = (const BitField &);
 
          bool isZero (void) const
           { return Zero; }
          long length (void) const
-          { if (Zero) return 0; return Data->Length; }
+          { if (Zero) return 0; return Data->Length + Offset; }
          long msb (void) const;
+         long lsb (void) const;
+         long popcount (void) const;
+         bool testBit (long) const;
 
          void comp (void);
 
@@ -129,6 +180,22 @@ namespace BigInt
 
          void split (BitField &, BitField &, long) const;
 
+          // Gets our own copy of a shared BitHolder, to give to another thread.
+         void unshare (void);
+          // Whether we are the very same number, so x * x can be a square.
+         bool shares (const BitField & src) const
+          { return !Zero && (Data == src.Data) && (Offset == src.Offset); }
+
+          // The low bytes of the number, as a little-endian byte string.
+         void exportBytes (unsigned char *, long) const;
+         void importBytes (const unsigned char *, long);
+
+          // Slices of at most bits bits, at any bit offset.
+         Unit getBits (long, int) const;
+         void setBits (long, int, Unit);
+          // A slice of any width
+         void getBits (BitField &, long, long) const;
+
          const static int bits;
 
     }; /* class BitField */
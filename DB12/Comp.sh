@@ -1 +1 @@
-g++ -s -Wall -Wextra -o DB12 -O6 main.cpp Parser.cpp Lexer.cpp Terp.cpp Number.cpp ../Integer.cpp ../BitField.cpp
+g++ -s -Wall -Wextra -o DB12 -O6 main.cpp Parser.cpp Lexer.cpp Terp.cpp Number.cpp ../Integer.cpp ../BitField.cpp ../Limbs.cpp ../Parallel.cpp ../Stats.cpp ../Sieve.cpp -pthread
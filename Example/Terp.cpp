@@ -29,81 +29,28 @@ extern char * Table [];
    each character as a base 256 digit and the string as a little-endian
    number.
  */
-#define UNIT_SIZE sizeof(BigInt::Unit)
 Integer intify (const string & src)
  {
    Integer result;
-   long curchar, digits, iter;
-   BigInt::Unit fatdigit, shift;
 
-   for (iter = src.length() - 1; iter >= 0;)
-    {
-      digits = UNIT_SIZE == 1 ? 1 : UNIT_SIZE - 1;
-      fatdigit = 0;
-      shift = 0;
-
-      for (; (iter >= 0) && digits; iter--, digits--)
-       {
-         curchar = (unsigned char) src[iter];
-
-         fatdigit <<= 8;
-         fatdigit += curchar;
-
-         shift += 8;
-       }
-
-      result <<= Integer(shift);
-      result |= Integer(fatdigit);
-    }
+   result.importBytes(src.data(), src.length());
 
    return result;
  }
 
  /*
-   Does the opposite of Intify.
+   Does the opposite of Intify. It stops at the first NUL, as these
+   have always been C strings.
  */
 string stringify (const Integer & src)
  {
-   string result;
-   int digit, index;
-   BigInt::Unit cur;
-   char * temp;
-
-   if (src.isZero()) return result;
-
-   temp = new char [(src.msb() / (UNIT_SIZE * 8) + 2) * (UNIT_SIZE * 8)];
-   digit = 0;
-   index = 0;
-
-   cur = src.getDigit(digit++);
-   while (cur)
-    {
-      temp[index++] = cur;
-      if (UNIT_SIZE > 1)
-       {
-         temp[index++] = cur >> 8;
-         if (UNIT_SIZE > 2)
-          {
-            temp[index++] = cur >> 16;
-            temp[index++] = cur >> 24;
-#if 0
-            if (UNIT_SIZE  > 4)
-             {
-               temp[index++] = cur >> 32;
-               temp[index++] = cur >> 40;
-               temp[index++] = cur >> 48;
-               temp[index++] = cur >> 56;
-             }
-#endif
-          }
-       }
-      cur = src.getDigit(digit++);
-    }
+   string result (src.exportSize(), '\0');
+   string::size_type end;
 
-   temp[index] ='\0';
+   if (!result.empty()) src.exportBytes(&result[0]);
 
-   result = temp;
-   delete [] temp;
+   end = result.find('\0');
+   if (end != string::npos) result.erase(end);
 
    return result;
  }
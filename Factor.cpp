@@ -0,0 +1,611 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+#include "Factor.hpp"
+#include "Sieve.hpp"
+
+namespace BigInt
+ {
+
+   FactorBudget::FactorBudget () :
+      seconds (0.0), trialLimit (65536), rhoIterations (1UL << 20),
+      maxB1 (1000000), maxCurves (0), threads (1), seed (1) { }
+
+
+
+   class Deadline
+    {
+      private:
+         bool limited;
+         std::chrono::steady_clock::time_point end;
+
+      public:
+         explicit Deadline (double seconds) : limited (seconds > 0.0)
+          {
+            if (limited) end = std::chrono::steady_clock::now() +
+               std::chrono::duration_cast<std::chrono::steady_clock::duration>
+                  (std::chrono::duration<double>(seconds));
+          }
+
+         bool expired (void) const
+          { return limited && (std::chrono::steady_clock::now() >= end); }
+    };
+
+
+
+    /*
+      The small remainder of a big number.
+    */
+   static Unit smallMod (const Integer & n, Unit d)
+    {
+      Integer q, r;
+      Integer::divmod(n, Integer(d), q, r);
+      return r.getDigit(0);
+    }
+
+    /*
+      BitField's reference counts are not atomic, so every worker thread
+      gets a copy of n that shares no storage with anything else.
+      The shift forces the copy-on-write.
+    */
+   static Integer privateCopy (const Integer & n)
+    {
+      Integer result (n);
+      result <<= Integer((Unit) 1);
+      result >>= Integer((Unit) 1);
+      return result;
+    }
+
+
+
+   bool isProbablePrime (const Integer & number, int rounds)
+    {
+      static const Unit bases [12] =
+         { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+      Integer n (abs(number)), one ((Unit) 1), nm1, d, x, a;
+      long s;
+
+      if (n.msb() < 1) return false;
+      for (int i = 0; i < 12; i++)
+         if (smallMod(n, bases[i]) == 0) return n == Integer(bases[i]);
+
+      nm1 = n - one;
+      s = nm1.lowestSetBit();
+      d = nm1 >> Integer((long long) s);
+
+      std::mt19937_64 random (n.getDigit(0));
+
+      for (int i = 0; i < rounds; i++)
+       {
+         if (i < 12) a = Integer(bases[i]);
+         else if ((i == 12) && (n.msb() < 81)) break; // Exact already
+         else a = Integer((Unit) (random() % 0xFFFFFFFFFFFFULL) + 2) % nm1;
+         if (a.isZero()) continue;
+
+         x = powMod(a, d, n);
+         if ((x == one) || (x == nm1)) continue;
+
+         long r;
+         for (r = 1; r < s; r++)
+          {
+            x = (x * x) % n;
+            if (x == nm1) break;
+            if (x == one) return false;
+          }
+         if (r == s) return false;
+       }
+
+      return true;
+    }
+
+
+
+    /*
+      Integer k-th root by Newton's method, rounded down.
+    */
+   static Integer iroot (const Integer & n, long k)
+    {
+      Integer K ((Unit) k), Km1 ((Unit) (k - 1)), x, y;
+
+      x = Integer((Unit) 1) << Integer((long long) (n.msb() / k + 1));
+      for (;;)
+       {
+         y = (Km1 * x + n / pow(x, Km1)) / K;
+         if (y >= x) break;
+         x = y;
+       }
+
+      return x;
+    }
+
+    /*
+      If n is r^k, for some prime k, return k and set root.
+    */
+   static long perfectPower (const Integer & n, Unit smallest, Integer & root)
+    {
+      long maxK;
+      Unit k;
+
+       // Trial division has already removed every factor below smallest.
+      maxK = n.msb() / (63 - __builtin_clzll(smallest)) + 1;
+
+      PrimeSieve ks (2, (Unit) maxK + 1);
+      while ((k = ks.next()) != 0)
+       {
+         Integer r = iroot(n, (long) k);
+         if (pow(r, Integer(k)) == n)
+          {
+            root = r;
+            return (long) k;
+          }
+       }
+
+      return 1;
+    }
+
+
+
+    /*
+      Pollard's rho, Brent's variant. The |x - y| are multiplied together
+      m at a time so that the GCD is taken once per batch; when a batch
+      overshoots and the GCD is n, we back up and go one step at a time.
+    */
+   static bool rho (const Integer & n, Unit c, unsigned long & budget,
+      const Deadline & deadline, Integer & found)
+    {
+      const unsigned long m = 128;
+      Integer C (c), x, y ((Unit) 2), ys, q ((Unit) 1), g ((Unit) 1);
+      Integer one ((Unit) 1);
+      unsigned long r = 1, k, i;
+
+      do
+       {
+         x = y;
+         for (i = 0; i < r; i++) y = (y * y + C) % n;
+         if (budget <= r) budget = 0;
+         else budget -= r;
+
+         for (k = 0; (k < r) && (g == one); k += m)
+          {
+            ys = y;
+            for (i = 0; (i < m) && (i < r - k); i++)
+             {
+               y = (y * y + C) % n;
+               q = (q * abs(x - y)) % n;
+             }
+            g = gcd(q, n);
+
+            if (budget <= i) budget = 0;
+            else budget -= i;
+            if (deadline.expired()) budget = 0;
+          }
+         r *= 2;
+       }
+      while ((g == one) && (budget != 0));
+
+      if (g == n)
+       {
+         do
+          {
+            ys = (ys * ys + C) % n;
+            g = gcd(abs(x - ys), n);
+          }
+         while (g == one);
+       }
+
+      if ((g == n) || (g == one)) return false;
+
+      found = g;
+      return true;
+    }
+
+
+
+    /*
+      Lenstra's ECM, on Montgomery curves By^2 = x^3 + Ax^2 + x with
+      Suyama's parameterization. Points are kept as (X : Z) and a24 is
+      (A + 2) / 4. Stage 2 is the standard continuation from Crandall
+      and Pomerance, "Prime Numbers", algorithm 7.4.4.
+    */
+   class Curve
+    {
+      public:
+         const Integer & n;
+         Integer a24;
+
+         explicit Curve (const Integer & mod) : n (mod) { }
+
+         Integer mulMod (const Integer & a, const Integer & b) const
+          { return mod(a * b, n); }
+
+         void dbl (Integer & X, Integer & Z,
+                   const Integer & PX, const Integer & PZ) const
+          {
+            Integer t1, t2, t3;
+            t1 = mulMod(PX + PZ, PX + PZ);
+            t2 = mulMod(PX - PZ, PX - PZ);
+            t3 = t1 - t2;
+            X = mulMod(t1, t2);
+            Z = mulMod(t3, t2 + mulMod(a24, t3));
+          }
+
+          // P + Q, where D = P - Q
+         void add (Integer & X, Integer & Z,
+                   const Integer & PX, const Integer & PZ,
+                   const Integer & QX, const Integer & QZ,
+                   const Integer & DX, const Integer & DZ) const
+          {
+            Integer u, v, s, t;
+            u = mulMod(PX - PZ, QX + QZ);
+            v = mulMod(PX + PZ, QX - QZ);
+            s = u + v;
+            t = u - v;
+            X = mulMod(DZ, mulMod(s, s));
+            Z = mulMod(DX, mulMod(t, t));
+          }
+
+          // Montgomery's ladder
+         void mul (Integer & X, Integer & Z, Unit k) const
+          {
+            Integer X0 (X), Z0 (Z), X1, Z1, PX (X), PZ (Z);
+            int bit;
+
+            if (k == 1) return;
+            dbl(X1, Z1, X0, Z0);
+            for (bit = 62 - __builtin_clzll(k); bit >= 0; bit--)
+             {
+               if (k & (((Unit) 1) << bit))
+                {
+                  add(X0, Z0, X1, Z1, X0, Z0, PX, PZ);
+                  dbl(X1, Z1, X1, Z1);
+                }
+               else
+                {
+                  add(X1, Z1, X1, Z1, X0, Z0, PX, PZ);
+                  dbl(X0, Z0, X0, Z0);
+                }
+             }
+            X = X0;
+            Z = Z0;
+          }
+    };
+
+   static const int ECM_D = 60;
+
+   static bool ecmCurve (const Integer & n, const Integer & sigma,
+      Unit B1, Unit B2, const Deadline & deadline,
+      const std::atomic<bool> & stop, Integer & found)
+    {
+      Curve E (n);
+      Integer u, v, X, Z, num, den, inv, g, one ((Unit) 1);
+      Unit p, i;
+
+      u = mod(sigma * sigma - Integer((Unit) 5), n);
+      v = mod(Integer((Unit) 4) * sigma, n);
+      X = mod(u * u * u, n);
+      Z = mod(v * v * v, n);
+      num = mod(pow(v - u, Integer((Unit) 3)) * (Integer((Unit) 3) * u + v),
+         n);
+      den = mod(Integer((Unit) 16) * X * v, n);
+      inv = modInv(den, n);
+      if (inv.isZero())
+       {
+         g = gcd(den, n);
+         if (g == one || g == n) return false;
+         found = g;
+         return true;
+       }
+      E.a24 = mod(num * inv, n);
+
+       // Stage 1
+      PrimeSieve stage1 (2, B1 + 1);
+      for (i = 0; (p = stage1.next()) != 0; i++)
+       {
+         Unit q = p;
+         while (q <= B1 / p) q *= p;
+         E.mul(X, Z, q);
+
+         if (((i & 255) == 0) && (stop || deadline.expired())) return false;
+       }
+
+      g = gcd(Z, n);
+      if (g == n) return false;
+      if (g != one)
+       {
+         found = g;
+         return true;
+       }
+
+       // Stage 2
+      Unit r = (B1 - 1) | 1;
+      if ((B2 <= B1) || (r <= 2 * ECM_D)) return false;
+
+      std::vector<Integer> SX (ECM_D + 1), SZ (ECM_D + 1), beta (ECM_D + 1);
+      Integer RX (X), RZ (Z), TX (X), TZ (Z), alpha, acc ((Unit) 1), tX, tZ;
+
+      E.dbl(SX[1], SZ[1], X, Z);
+      E.dbl(SX[2], SZ[2], SX[1], SZ[1]);
+      for (int d = 3; d <= ECM_D; d++)
+         E.add(SX[d], SZ[d], SX[d - 1], SZ[d - 1], SX[1], SZ[1],
+            SX[d - 2], SZ[d - 2]);
+      for (int d = 1; d <= ECM_D; d++) beta[d] = E.mulMod(SX[d], SZ[d]);
+
+      E.mul(RX, RZ, r);
+      E.mul(TX, TZ, r - 2 * ECM_D);
+
+      PrimeSieve stage2 (r + 1, B2 + 1);
+      for (p = stage2.next(); p != 0; r += 2 * ECM_D)
+       {
+         alpha = E.mulMod(RX, RZ);
+         for (; (p != 0) && (p <= r + 2 * ECM_D); p = stage2.next())
+          {
+            int d = (int) ((p - r) / 2);
+            acc = E.mulMod(acc,
+               E.mulMod(RX - SX[d], RZ + SZ[d]) - alpha + beta[d]);
+          }
+
+         E.add(tX, tZ, RX, RZ, SX[ECM_D], SZ[ECM_D], TX, TZ);
+         TX = RX;
+         TZ = RZ;
+         RX = tX;
+         RZ = tZ;
+
+         if (stop || deadline.expired()) break;
+       }
+
+      g = gcd(acc, n);
+      if ((g == n) || (g == one)) return false;
+
+      found = g;
+      return true;
+    }
+
+    /*
+      Run up to curves curves with the given bounds, spread over threads.
+      Each curve is independent, so the first one to find a factor wins.
+    */
+   static bool ecm (const Integer & n, Unit B1, Unit B2,
+      unsigned long curves, const FactorBudget & budget,
+      const Deadline & deadline,
+      unsigned long & sigmaSeed, Integer & found)
+    {
+      unsigned int threads = budget.threads ? budget.threads : 1;
+      std::atomic<unsigned long> next (0);
+      std::atomic<bool> stop (false);
+      std::mutex lock;
+      bool success = false;
+      const unsigned long firstSeed = sigmaSeed;
+
+      if (threads > curves) threads = (unsigned int) curves;
+
+      std::vector<Integer> ns;
+      for (unsigned int t = 0; t < threads; t++) ns.push_back(privateCopy(n));
+
+      auto worker = [&] (unsigned int t)
+       {
+         const Integer & N = ns[t];
+         Integer sigma, f;
+
+         for (;;)
+          {
+            unsigned long c = next++;
+            if ((c >= curves) || stop || deadline.expired()) break;
+
+            std::mt19937_64 random (firstSeed + c);
+            sigma = mod(Integer((Unit) random()), N - Integer((Unit) 7)) +
+               Integer((Unit) 6);
+
+            if (ecmCurve(N, sigma, B1, B2, deadline, stop, f))
+             {
+               std::lock_guard<std::mutex> guard (lock);
+               if (!success)
+                {
+                  found = privateCopy(f);
+                  success = true;
+                }
+               stop = true;
+               break;
+             }
+          }
+       };
+
+      if (threads == 1) worker(0);
+      else
+       {
+         std::vector<std::thread> pool;
+         for (unsigned int t = 0; t < threads; t++)
+            pool.push_back(std::thread(worker, t));
+         for (unsigned int t = 0; t < threads; t++) pool[t].join();
+       }
+
+      sigmaSeed += curves;
+      return success;
+    }
+
+
+
+    /*
+      The GMP-ECM table of optimal B1 and expected curves by factor size,
+      from 15 digits up to 50.
+    */
+   static const Unit ecmB1 [] =
+      { 2000, 11000, 50000, 250000, 1000000, 3000000, 11000000, 43000000 };
+   static const unsigned long ecmCurves [] =
+      { 25, 90, 300, 700, 1800, 5100, 10600, 19300 };
+
+   static bool findDivisor (const Integer & n, const FactorBudget & budget,
+      const Deadline & deadline,
+      unsigned long & sigmaSeed, Integer & found)
+    {
+      unsigned long rhoBudget = budget.rhoIterations;
+      unsigned long curvesLeft = budget.maxCurves;
+
+      for (Unit c = 1; (rhoBudget != 0) && (c < 16); c += 2)
+         if (rho(n, c, rhoBudget, deadline, found)) return true;
+
+      for (size_t level = 0; level < sizeof(ecmB1) / sizeof(Unit); level++)
+       {
+         Unit B1 = ecmB1[level];
+         unsigned long curves = ecmCurves[level];
+
+         if ((B1 > budget.maxB1) || deadline.expired()) break;
+         if (budget.maxCurves != 0)
+          {
+            if (curvesLeft == 0) break;
+            if (curves > curvesLeft) curves = curvesLeft;
+            curvesLeft -= curves;
+          }
+
+         if (ecm(n, B1, 100 * B1, curves, budget, deadline,
+            sigmaSeed, found)) return true;
+       }
+
+      return false;
+    }
+
+
+
+   static void addFactor (std::vector<PrimeFactor> & result,
+      const Integer & value, unsigned long power, bool prime)
+    {
+      for (size_t i = 0; i < result.size(); i++)
+       {
+         if (result[i].value == value)
+          {
+            result[i].power += power;
+            return;
+          }
+       }
+      result.push_back(PrimeFactor(value, power, prime));
+    }
+
+   static bool byValue (const PrimeFactor & lhs, const PrimeFactor & rhs)
+    {
+      return lhs.value < rhs.value;
+    }
+
+   std::vector<PrimeFactor> factor (const Integer & number,
+      const FactorBudget & budget)
+    {
+      std::vector<PrimeFactor> result;
+      std::vector<std::pair<Integer, unsigned long> > work;
+      Integer n (abs(number)), one ((Unit) 1), d;
+      Deadline deadline (budget.seconds);
+      unsigned long sigmaSeed = budget.seed;
+      Unit p, bound, limit = budget.trialLimit;
+
+      if (n.msb() < 1) return result; // 0 and 1
+      if (limit < 2) limit = 2;
+      if (limit > 0xFFFFFFFFULL) limit = 0xFFFFFFFFULL;
+
+       /*
+         Trial division. The primes are multiplied together as long as the
+         product fits in a Unit, so that one long division tests several of
+         them at once. Afterwards, n has no prime factors below bound.
+       */
+      PrimeSieve trial (2, limit + 1);
+      p = trial.next();
+      while ((p != 0) && (Integer(p * p) <= n))
+       {
+         Unit group [8], product = 1, rem;
+         int count = 0;
+
+         while ((count < 8) && (p != 0) && (product <= (Unit) -1 / p))
+          {
+            product *= p;
+            group[count++] = p;
+            p = trial.next();
+          }
+
+         rem = smallMod(n, product);
+         for (int j = 0; j < count; j++)
+          {
+            if (rem % group[j] != 0) continue;
+
+            unsigned long power = 0;
+            do
+             {
+               n /= Integer(group[j]);
+               power++;
+             }
+            while (smallMod(n, group[j]) == 0);
+            addFactor(result, Integer(group[j]), power, true);
+          }
+       }
+      bound = (p != 0) ? p : limit + 1;
+
+      if (n != one)
+       {
+          // No factor up to the square root means that n is prime.
+         if (Integer(bound) * Integer(bound) > n)
+            addFactor(result, n, 1, true);
+         else work.push_back(std::make_pair(n, 1UL));
+       }
+
+      while (!work.empty())
+       {
+         Integer m (work.back().first), root;
+         unsigned long power = work.back().second;
+         long k;
+
+         work.pop_back();
+
+         if (isProbablePrime(m))
+          {
+            addFactor(result, m, power, true);
+            continue;
+          }
+
+         k = perfectPower(m, bound, root);
+         if (k > 1)
+          {
+            work.push_back(std::make_pair(root, power * k));
+            continue;
+          }
+
+         if (!deadline.expired() &&
+             findDivisor(m, budget, deadline, sigmaSeed, d))
+          {
+            work.push_back(std::make_pair(d, power));
+            work.push_back(std::make_pair(m / d, power));
+          }
+         else addFactor(result, m, power, false);
+       }
+
+      std::sort(result.begin(), result.end(), byValue);
+      return result;
+    }
+
+ } /* namespace BigInt */
@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+/*
+   Integer factorization.
+
+   factor() escalates through the usual methods, cheapest first:
+      trial division by the primes from a PrimeSieve,
+      a perfect power check,
+      Pollard's rho with Brent's cycle finding and batched GCDs,
+      Lenstra's elliptic curve method (stage 1 and stage 2).
+
+   The work done is bounded by a FactorBudget. When the budget runs out,
+   whatever could not be split is returned with isPrime set to false, so
+   the product of the result is always the magnitude of the input.
+*/
+
+#ifndef FACTOR_HPP
+#define FACTOR_HPP
+
+#include <vector>
+#include "Integer.hpp"
+
+namespace BigInt
+ {
+
+   class FactorBudget
+    {
+      public:
+         double seconds;              // Wall clock limit, 0 for none
+         Unit trialLimit;             // Largest trial divisor
+         unsigned long rhoIterations; // Per composite
+         Unit maxB1;                  // Largest ECM stage 1 bound tried
+         unsigned long maxCurves;     // Per composite, 0 for the schedule
+         unsigned int threads;        // Threads running ECM curves
+         unsigned long seed;
+
+         FactorBudget ();
+    };
+
+   class PrimeFactor
+    {
+      public:
+         Integer value;
+         unsigned long power;
+         bool isPrime; // False only if the budget ran out
+
+         PrimeFactor (const Integer & v, unsigned long p, bool prime) :
+            value (v), power (p), isPrime (prime) { }
+    };
+
+    /*
+      Miller-Rabin. The first twelve prime bases make this exact below
+      3.3 * 10^24; beyond that, the remaining rounds use random bases.
+    */
+   bool isProbablePrime (const Integer &, int rounds = 25);
+
+    /*
+      Factors the magnitude of the argument. The result is sorted by value.
+      Zero and one have no factors.
+    */
+   std::vector<PrimeFactor> factor (const Integer &,
+      const FactorBudget & budget = FactorBudget());
+
+ } /* namespace BigInt */
+
+#endif /* FACTOR_HPP */
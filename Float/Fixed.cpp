@@ -36,6 +36,9 @@ SUCH DAMAGE.
 */
 
 #include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <ostream>
 #include <string>
 #include "Fixed.hpp"
 
@@ -268,22 +271,150 @@ namespace BigInt
     }
 
 
+   static const unsigned char FixedMagic [4] = { 'A', 'P', 'F', 'X' };
+   static const unsigned char FixedVersion = 1;
+   static const size_t FixedHeader = 16;
+
+   static bool goodHeader (const unsigned char * src)
+    {
+      return (std::memcmp(src, FixedMagic, 4) == 0) &&
+         (src[4] != 0) && (src[4] <= FixedVersion) &&
+         (src[5] == 0) && (src[6] == 0) && (src[7] == 0);
+    }
+
+   static unsigned long readPrecision (const unsigned char * src)
+    {
+      unsigned long long result = 0;
+      for (int i = 7; i >= 0; i--) result = (result << 8) | src[i];
+      return (unsigned long) result;
+    }
+
+   static void writeHeader (unsigned char * dest, unsigned long precision)
+    {
+      std::memcpy(dest, FixedMagic, 4);
+      dest[4] = FixedVersion;
+      dest[5] = dest[6] = dest[7] = 0;
+      for (int i = 0; i < 8; i++)
+         dest[8 + i] = (unsigned char) ((unsigned long long) precision >> (i * 8));
+    }
+
+   size_t Fixed::serializedSize (void) const
+    {
+      return FixedHeader + Data.serializedSize();
+    }
+
+   size_t Fixed::serialize (unsigned char * dest) const
+    {
+      writeHeader(dest, Digits);
+      return FixedHeader + Data.serialize(dest + FixedHeader);
+    }
+
+   size_t Fixed::deserialize (const unsigned char * src, size_t length)
+    {
+      Integer temp;
+      size_t used;
+
+      if ((length < FixedHeader) || !goodHeader(src)) return 0;
+
+      used = temp.deserialize(src + FixedHeader, length - FixedHeader);
+      if (used == 0) return 0;
+
+      Data = temp;
+      Digits = readPrecision(src + 8);
+
+      return FixedHeader + used;
+    }
+
+   bool Fixed::serialize (std::ostream & dest) const
+    {
+      unsigned char header [FixedHeader];
+
+      writeHeader(header, Digits);
+      dest.write((const char *) header, FixedHeader);
+
+      return !dest.fail() && Data.serialize(dest);
+    }
+
+   bool Fixed::deserialize (std::istream & src)
+    {
+      unsigned char header [FixedHeader];
+      Integer temp;
+
+      if (!src.read((char *) header, FixedHeader) || !goodHeader(header) ||
+          !temp.deserialize(src))
+         return false;
+
+      Data = temp;
+      Digits = readPrecision(header + 8);
+
+      return true;
+    }
+
+
    std::string Fixed::toString (void) const
     {
-      std::string result;
+      std::string result, sign;
       result = Data.toString();
       if (Digits == 0) return result;
+      if (Data.isSigned())
+       {
+         sign = "-";
+         result.erase(0, 1);
+       }
       if (result.length() <= Digits)
        {
-         while (result.length() < Digits) result = '0' + result;
+         result.insert(0, Digits - result.length(), '0');
          result = '0' + (SEPERATOR + result);
        }
       else
        {
-         result = result.substr(0, result.length() - Digits) + SEPERATOR +
-            result.substr(result.length() - Digits, Digits);
+         result.insert(result.length() - Digits, 1, SEPERATOR);
        }
-      return result;
+      return sign + result;
+    }
+
+   static bool insert (const char * src, size_t count, void * dest)
+    {
+      return !((std::ostream *) dest)->write(src, count).fail();
+    }
+
+    /*
+      The whole part and the fraction are written separately, so that
+      nothing has to know how long the whole thing is.
+    */
+   std::ostream & operator << (std::ostream & dest, const Fixed & src)
+    {
+      Integer whole, part;
+
+      if (dest.width() > 0) return dest << src.toString();
+
+      std::ostream::sentry ok (dest);
+      if (!ok) return dest;
+
+      if (src.Digits == 0)
+       {
+         if (!src.Data.write(insert, &dest)) dest.setstate(std::ios::badbit);
+         return dest;
+       }
+
+      Integer::divmod(abs(src.Data),
+         pow(Integer((Unit) 10), Integer((long long) src.Digits)), whole, part);
+
+      if (src.Data.isSigned()) dest.put('-');
+      if (!whole.write(insert, &dest) || !dest.put(SEPERATOR) ||
+          !part.write(insert, &dest, 10, src.Digits))
+         dest.setstate(std::ios::badbit);
+
+      return dest;
+    }
+
+   std::istream & operator >> (std::istream & src, Fixed & dest)
+    {
+      std::string word;
+
+      if (src >> word) dest.fromString(word);
+
+      return src;
     }
 
 
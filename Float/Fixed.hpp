@@ -97,6 +97,18 @@ namespace BigInt
 
          std::string toString (void) const;
 
+          /*
+            The binary format is a 16 byte header, "APFX", a version byte
+            (1), three zero bytes, and the precision as a little-endian 64 bit
+            number, followed by Data in Integer's format. These behave like
+            Integer's.
+          */
+         size_t serializedSize (void) const;
+         size_t serialize (unsigned char *) const;
+         size_t deserialize (const unsigned char *, size_t);
+         bool serialize (std::ostream &) const;
+         bool deserialize (std::istream &);
+
          void fromString (const std::string & src)
             { fromString(src.c_str()); }
          void fromString (const char *);
@@ -131,8 +143,17 @@ namespace BigInt
 
          Integer roundToInteger (void) const;
 
+         friend std::ostream & operator << (std::ostream &, const Fixed &);
+
     }; /* class Fixed */
 
+    /*
+      These write the same thing as toString(), without building it first,
+      and read a whitespace delimited word with fromString().
+    */
+   std::ostream & operator << (std::ostream &, const Fixed &);
+   std::istream & operator >> (std::istream &, Fixed &);
+
    Fixed operator + (const Fixed &, const Fixed &);
    Fixed operator - (const Fixed &, const Fixed &);
    Fixed operator * (const Fixed &, const Fixed &);
@@ -31,6 +31,8 @@ SUCH DAMAGE.
 #include <string>
 #include <sstream>
 #include <cstring>
+#include <istream>
+#include <ostream>
 #include "Float.hpp"
 
 #ifndef SEPERATOR
@@ -518,6 +520,94 @@ namespace BigInt
     }
 
 
+   static const unsigned char FloatMagic [4] = { 'A', 'P', 'F', 'L' };
+   static const unsigned char FloatVersion = 1;
+   static const size_t FloatHeader = 16;
+
+   static bool goodHeader (const unsigned char * src)
+    {
+      return (std::memcmp(src, FloatMagic, 4) == 0) &&
+         (src[4] != 0) && (src[4] <= FloatVersion) &&
+         ((src[5] & ~7) == 0) && (src[6] == 0) && (src[7] == 0);
+    }
+
+   static void writeHeader (unsigned char * dest,
+      bool sign, bool infinity, bool nan, long exponent)
+    {
+      std::memcpy(dest, FloatMagic, 4);
+      dest[4] = FloatVersion;
+      dest[5] = (sign ? 1 : 0) | (infinity ? 2 : 0) | (nan ? 4 : 0);
+      dest[6] = dest[7] = 0;
+      for (int i = 0; i < 8; i++)
+         dest[8 + i] = (unsigned char) ((unsigned long long) exponent >> (i * 8));
+    }
+
+   static long readExponent (const unsigned char * src)
+    {
+      unsigned long long result = 0;
+      for (int i = 7; i >= 0; i--) result = (result << 8) | src[i];
+      return (long) (long long) result;
+    }
+
+   size_t Float::serializedSize (void) const
+    {
+      return FloatHeader + Data.serializedSize();
+    }
+
+   size_t Float::serialize (unsigned char * dest) const
+    {
+      writeHeader(dest, Sign, Infinity, NaN, Exponent);
+      return FloatHeader + Data.serialize(dest + FloatHeader);
+    }
+
+   size_t Float::deserialize (const unsigned char * src, size_t length)
+    {
+      Fixed temp;
+      size_t used;
+
+      if ((length < FloatHeader) || !goodHeader(src)) return 0;
+
+      used = temp.deserialize(src + FloatHeader, length - FloatHeader);
+      if (used == 0) return 0;
+
+      Data = temp.abs();
+      Sign = (src[5] & 1) != 0;
+      Infinity = (src[5] & 2) != 0;
+      NaN = (src[5] & 4) != 0;
+      Exponent = readExponent(src + 8);
+
+      return FloatHeader + used;
+    }
+
+   bool Float::serialize (std::ostream & dest) const
+    {
+      unsigned char header [FloatHeader];
+
+      writeHeader(header, Sign, Infinity, NaN, Exponent);
+      dest.write((const char *) header, FloatHeader);
+
+      return !dest.fail() && Data.serialize(dest);
+    }
+
+   bool Float::deserialize (std::istream & src)
+    {
+      unsigned char header [FloatHeader];
+      Fixed temp;
+
+      if (!src.read((char *) header, FloatHeader) || !goodHeader(header) ||
+          !temp.deserialize(src))
+         return false;
+
+      Data = temp.abs();
+      Sign = (header[5] & 1) != 0;
+      Infinity = (header[5] & 2) != 0;
+      NaN = (header[5] & 4) != 0;
+      Exponent = readExponent(header + 8);
+
+      return true;
+    }
+
+
    std::string Float::toString (void) const
     {
       if (NaN) return std::string ("NaN");
@@ -537,6 +627,27 @@ namespace BigInt
     }
 
 
+   std::ostream & operator << (std::ostream & dest, const Float & src)
+    {
+      if (dest.width() > 0) return dest << src.toString();
+
+      if (src.NaN) return dest << "NaN";
+      if (src.Infinity) return dest << (src.Sign ? "-Inf" : "Inf");
+
+      if (src.Sign) dest << '-';
+      return dest << src.Data << 'E' << src.Exponent;
+    }
+
+   std::istream & operator >> (std::istream & src, Float & dest)
+    {
+      std::string word;
+
+      if (src >> word) dest.fromString(word);
+
+      return src;
+    }
+
+
    void Float::fromString (const char * src)
     {
       if (!std::strcmp(src, "Inf") || !std::strcmp(src, "+Inf") ||
@@ -97,6 +97,19 @@ namespace BigInt
 
          std::string toString (void) const;
 
+          /*
+            The binary format is a 16 byte header, "APFL", a version byte
+            (1), a flags byte (bit 0 the sign, bit 1 Infinity, bit 2 NaN), two
+            zero bytes, and the Exponent as a little-endian 64 bit two's
+            complement number, followed by Data in Fixed's format. These
+            behave like Integer's.
+          */
+         size_t serializedSize (void) const;
+         size_t serialize (unsigned char *) const;
+         size_t deserialize (const unsigned char *, size_t);
+         bool serialize (std::ostream &) const;
+         bool deserialize (std::istream &);
+
          void fromString (const std::string & src)
             { fromString(src.c_str()); }
          void fromString (const char *);
@@ -151,8 +164,16 @@ namespace BigInt
          friend Float exp (const Float &);
          friend Float log (const Float &);
 
+         friend std::ostream & operator << (std::ostream &, const Float &);
+
     }; /* class Float */
 
+    /*
+      As for Fixed: the same as toString(), and a word with fromString().
+    */
+   std::ostream & operator << (std::ostream &, const Float &);
+   std::istream & operator >> (std::istream &, Float &);
+
    bool operator > (const Float &, const Float &);
    bool operator < (const Float &, const Float &);
    bool operator >= (const Float &, const Float &);
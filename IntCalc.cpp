@@ -61,6 +61,13 @@ bool LastNum = false;
  */
 bool Error = false;
 
+ /*
+   Did something in this calculation run out of budget? Then there's no
+   answer to print. The default budget is a gigabyte of Units.
+ */
+bool Exhausted = false;
+const long DefaultBudget = 1L << 27;
+
 /*
    Turn the ASCII value of the token read into a token number.
    Return the index of the token in "+-*""/%^!()~PCNMGLI|SF", if one of these.
@@ -229,26 +236,37 @@ string GetString (void)
 Integer operate (int operation, Integer * A, Integer * B)
  {
    Integer result, remainder;
-   switch (operation)
+   if (Exhausted) return Integer((BigInt::Unit) 0);
+   try
+    {
+      switch (operation)
+       {
+         case  0: return *A + *B;
+         case  1: return *A - *B;
+         case  2: return *A * *B;
+         case  3: return div(*A, *B);
+         case  4: return mod(*A, *B);
+         case  5: return pow(*A, *B);
+         case  6: return fact(*A);
+         case  9: return -(*A);
+         case 10: return permutation(*A, *B);
+         case 11: return combination(*A, *B);
+         case 12: return min(*A, *B);
+         case 13: return max(*A, *B);
+         case 14: return gcd(*A, *B);
+         case 15: return lcm(*A, *B);
+         case 16: return modInv(*A, *B);
+         case 17: return abs(*A);
+         case 18: return sqrt(*A);
+         case 19: return fib(*A);
+       }
+    }
+   catch (const BigInt::Budget_Exceeded &)
     {
-      case  0: return *A + *B;
-      case  1: return *A - *B;
-      case  2: return *A * *B;
-      case  3: return div(*A, *B);
-      case  4: return mod(*A, *B);
-      case  5: return pow(*A, *B);
-      case  6: return fact(*A);
-      case  9: return -(*A);
-      case 10: return permutation(*A, *B);
-      case 11: return combination(*A, *B);
-      case 12: return min(*A, *B);
-      case 13: return max(*A, *B);
-      case 14: return gcd(*A, *B);
-      case 15: return lcm(*A, *B);
-      case 16: return modInv(*A, *B);
-      case 17: return abs(*A);
-      case 18: return sqrt(*A);
-      case 19: return fib(*A);
+      cerr << "Out of memory: that number is too big." << endl;
+      Error = true;
+      Exhausted = true;
+      return Integer((BigInt::Unit) 0);
     }
 
    cerr << "Internal Error: " << __LINE__ << ". Aborting Calculator." << endl;
@@ -284,20 +302,24 @@ int main (int argc, char ** argv)
 
    Integer lhs, rhs, last;
    int ibase = 10, obase = 10;
+   long budget = DefaultBudget;
 
    if (argc > 1)
     {
       obase = atoi(argv[1]);
       if (argc > 2) ibase = atoi(argv[2]);
+      if (argc > 3) budget = atol(argv[3]) * (1L << 17);
 
       if ((ibase < 2) || (ibase > 36) || (obase < 2) || (obase > 36))
        {
-         cerr << argv[0] << " [output_base [input_base]]" << endl;
+         cerr << argv[0] << " [output_base [input_base [megabytes]]]" << endl;
          cerr << "Input and output bases must be greater than one"
             " and less than thirty-seven." << endl;
        }
     }
 
+   BigInt::BitField::setBudget(budget);
+
    cerr << "Integer Playground by Thomas DiModica." << endl
         << "Copyright 2010, 2011." << endl
         << "This software comes with ABSOLUTELY NO WARRANTY." << endl;
@@ -504,7 +526,18 @@ ReadANumberInstead:
       if (!DataStack.empty()) lhs = DataStack.top();
       else lhs = Integer((BigInt::Unit) 0);
 
-      cout << lhs.toString(obase) << endl;
+      if (!Exhausted)
+       {
+         try
+          {
+            cout << lhs.toString(obase) << endl;
+          }
+         catch (const BigInt::Budget_Exceeded &)
+          {
+            cerr << "Out of memory: that number is too big to print." << endl;
+            Exhausted = true;
+          }
+       }
 
        // Clear the stacks, just to be sure. They SHOULD be empty right now.
       while (!DataStack.empty()) DataStack.pop();
@@ -512,7 +545,8 @@ ReadANumberInstead:
 
        // Reset this. It's important.
       LastNum = false;
-      last = lhs;
+      if (!Exhausted) last = lhs;
+      Exhausted = false;
 
        // More input?
       GetFirstToken();
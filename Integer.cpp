@@ -27,11 +27,53 @@ OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
 SUCH DAMAGE.
 */
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
 #include "Integer.hpp"
+#include "Limbs.hpp"
+#include "Parallel.hpp"
+#include "Sieve.hpp"
+#include "Stats.hpp"
+
+ // Bench/Tune writes this, with numbers for this machine.
+#if defined(__has_include)
+ #if __has_include("Tuned.hpp")
+  #include "Tuned.hpp"
+ #endif
+#endif
+
+#ifndef K_CUT
+ #define K_CUT 56
+#endif
+#ifndef SQR_CUT
+ #define SQR_CUT K_CUT
+#endif
+#ifndef CONVERT_CUT
+ #define CONVERT_CUT 16
+#endif
 
 namespace BigInt
  {
 
+   Integer_Thresholds Integer::thresholds = { K_CUT, SQR_CUT, CONVERT_CUT };
+
+    /*
+      Karatsuba needs two Units to split, and radix conversion needs one.
+      Anything less than that is taken to mean that.
+    */
+   Integer_Thresholds Integer::setThresholds (const Integer_Thresholds & to)
+    {
+      thresholds.Multiply = std::max(to.Multiply, 2L);
+      thresholds.Square = std::max(to.Square, 2L);
+      thresholds.Convert = std::max(to.Convert, 1L);
+      return thresholds;
+    }
+
    Integer::Integer () : Digits (), Sign (false) { }
 
     /*
@@ -94,6 +136,68 @@ namespace BigInt
 
 
 
+    /*
+      Bit slices of the magnitude. Where the old way to read an array out
+      of an Integer was to shift and mask the whole thing, these only
+      touch the Units that hold the slice, and setBits only copies if the
+      Digits are shared. Negative offsets and widths read as zero and
+      write nothing.
+    */
+   Integer Integer::getBits (long offset, long width) const
+    {
+      Integer result;
+
+      if ((offset < 0) || (width <= 0)) return result;
+
+      if (width <= BitField::bits)
+         result.Digits = BitField(Digits.getBits(offset, (int)width));
+      else
+         Digits.getBits(result.Digits, offset, width);
+
+      return result;
+    }
+
+   Integer & Integer::setBits (long offset, long width, const Integer & value)
+    {
+      if ((offset < 0) || (width <= 0)) return *this;
+
+      long i = (width - 1) / BitField::bits;
+
+       /*
+         Do the top Unit first, so a number that grows only grows once.
+         Going down, value may be us, but we only overwrite bits of it that
+         we have already read.
+       */
+      Digits.setBits(offset + i * BitField::bits,
+         (int)(width - i * BitField::bits),
+         value.Digits.getBits(i * BitField::bits,
+            (int)(width - i * BitField::bits)));
+      for (--i; i >= 0; --i)
+         Digits.setBits(offset + i * BitField::bits, BitField::bits,
+            value.Digits.getBits(i * BitField::bits, BitField::bits));
+
+      if (isZero()) Sign = false;
+      return *this;
+    }
+
+   Unit Integer::getByte (long index) const
+    {
+      if (index < 0) return 0;
+      return Digits.getBits(index * 8, 8);
+    }
+
+   Integer & Integer::setByte (long index, Unit value)
+    {
+      if (index < 0) return *this;
+
+      Digits.setBits(index * 8, 8, value);
+
+      if (isZero()) Sign = false;
+      return *this;
+    }
+
+
+
    Integer & Integer::negate (void)
     {
       if (isZero()) Sign = false;
@@ -335,14 +439,93 @@ namespace BigInt
       This is the standard O(n^2) algorithm for multiplication.
       Karatsuba multiplication is poorly implemented.
     */
-#ifndef K_CUT
- #define K_CUT 56
-#endif
+    /*
+      A product for another thread. Left and Right must share nothing with
+      anybody else, and Result isn't looked at until the Task is done.
+    */
+   class ParallelProduct
+    {
+      public:
+         Integer Left, Right, Result;
+
+         static void run (void * piece)
+          {
+            ParallelProduct * self = (ParallelProduct *) piece;
+            self->Result = self->Left * self->Right;
+          }
+    };
+
+    /*
+      The three products of a Karatsuba step, with the threads we have
+      split between them. This thread does B * D, which is the only one
+      that might share a BitHolder with the operands.
+    */
+   void Integer::karatsuba (const Integer & A, const Integer & B,
+      const Integer & C, const Integer & D, Integer & Z2, Integer & Z1,
+      Integer & Z0)
+    {
+      int threads = Parallel::threads();
+      ParallelProduct high, middle;
+
+      Stats::chose(Stats::MULTIPLY_PARALLEL,
+         std::max(A.Digits.length(), C.Digits.length()) * 2);
+
+       // Pick the kernels now, rather than have the threads race to.
+      Limbs::arithmeticKernel();
+
+       // Squares stay squares: the copies may share with each other.
+      middle.Left = A + B;
+      middle.Left.Digits.unshare();
+      if (A.Digits.shares(C.Digits) && B.Digits.shares(D.Digits))
+         middle.Right = middle.Left;
+      else
+       {
+         middle.Right = C + D;
+         middle.Right.Digits.unshare();
+       }
+
+      if (threads == 2)
+       {
+         Parallel::Task task (ParallelProduct::run, &middle, 1);
+          {
+            Parallel::Limit limit (1);
+            Z2 = A * C;
+            Z0 = B * D;
+          }
+         task.wait();
+       }
+      else
+       {
+         high.Left = A;
+         high.Left.Digits.unshare();
+         if (A.Digits.shares(C.Digits)) high.Right = high.Left;
+         else
+          {
+            high.Right = C;
+            high.Right.Digits.unshare();
+          }
+
+         Parallel::Task first (ParallelProduct::run, &middle, (threads + 2) / 3);
+         Parallel::Task second (ParallelProduct::run, &high, (threads + 1) / 3);
+          {
+            Parallel::Limit limit (threads / 3);
+            Z0 = B * D;
+          }
+         first.wait();
+         second.wait();
+
+         Z2 = high.Result;
+       }
+
+      Z1 = middle.Result;
+    }
+
    Integer operator * (const Integer & lhs, const Integer & rhs)
     {
       Integer result;
-      BitField temp;
-      long i;
+      bool square = lhs.Digits.shares(rhs.Digits);
+      long cut = square ? Integer::thresholds.Square :
+         Integer::thresholds.Multiply;
 
        // 0 * x = x * 0 = 0
       if (lhs.isZero() || rhs.isZero()) return result;
@@ -352,6 +535,7 @@ namespace BigInt
        //Easy case 1: rhs is one digit
       if (rhs.Digits.length() == 1)
        {
+         Stats::chose(Stats::MULTIPLY_SHORT, lhs.Digits.length());
          result.Digits = lhs.Digits;
          result.Digits *= rhs.Digits.getDigit(0);
          return result;
@@ -360,48 +544,53 @@ namespace BigInt
        //Easy case 2: lhs is one digit
       if (lhs.Digits.length() == 1)
        {
+         Stats::chose(Stats::MULTIPLY_SHORT, rhs.Digits.length());
          result.Digits = rhs.Digits;
          result.Digits *= lhs.Digits.getDigit(0);
          return result;
        }
 
        // Check for doing Karatsuba multiplication
-      if ((rhs.Digits.length() < K_CUT) || (lhs.Digits.length() < K_CUT))
+      if ((rhs.Digits.length() < cut) || (lhs.Digits.length() < cut))
        {
           //Do long multiplication.
-         if (rhs.Digits.length() >= lhs.Digits.length())
-          { //iterate over lhs, as it is smaller
-            for (i = 0; i < lhs.Digits.length(); i++)
-             {
-               temp = rhs.Digits;
-               temp *= lhs.Digits.getDigit(i); //We should save time by putting
-               temp <<= i * BitField::bits; //the multiply before the shift.
-               result.Digits += temp;
-             }
-          }
-         else
-          { //iterate over rhs, as it is smaller
-            for (i = 0; i < rhs.Digits.length(); i++)
-             {
-               temp = lhs.Digits;
-               temp *= rhs.Digits.getDigit(i);
-               temp <<= i * BitField::bits;
-               result.Digits += temp;
-             }
-          }
+         Stats::chose(Stats::MULTIPLY_LONG,
+            std::max(lhs.Digits.length(), rhs.Digits.length()));
+         result.Digits.multiply(lhs.Digits, rhs.Digits);
        }
       else
        {
          const long cutoff = ((rhs.Digits.length() >= lhs.Digits.length()) ? rhs.Digits.length() : lhs.Digits.length()) / 2;
+         Stats::chose(square ? Stats::SQUARE_KARATSUBA :
+            Stats::MULTIPLY_KARATSUBA, 2 * cutoff);
          Integer shift = Integer(((Unit)cutoff * BitField::bits));
          Integer shift2 = Integer(((Unit)2 * cutoff * BitField::bits));
-         Integer A, B, C, D, Z0, Z2;
+         Integer A, B, C, D, Z0, Z1, Z2;
          lhs.Digits.split(A.Digits, B.Digits, cutoff);
-         rhs.Digits.split(C.Digits, D.Digits, cutoff);
+         if (square)
+          {
+            C = A;
+            D = B;
+          }
+         else rhs.Digits.split(C.Digits, D.Digits, cutoff);
 
-         Z2 = A * C;
-         Z0 = B * D;
-         result = (Z2 << shift2) + (((A + B) * (C + D) - Z2 - Z0) << shift) + Z0;
+         if ((Parallel::threads() > 1) && (std::min(lhs.Digits.length(),
+               rhs.Digits.length()) >= Parallel::getCutoff()))
+            Integer::karatsuba(A, B, C, D, Z2, Z1, Z0);
+         else if (square)
+          {
+            Z2 = A * A;
+            Z0 = B * B;
+            Z1 = A + B;
+            Z1 = Z1 * Z1;
+          }
+         else
+          {
+            Z2 = A * C;
+            Z0 = B * D;
+            Z1 = (A + B) * (C + D);
+          }
+         result = (Z2 << shift2) + ((Z1 - Z2 - Z0) << shift) + Z0;
          result.Sign = (lhs.isSigned() != rhs.isSigned());
        }
 
@@ -579,59 +768,87 @@ namespace BigInt
 
 
 
-   void Integer::fromString (const std::string & src, int base)
+    /*
+      Digit packing is NECESSARY for toString to be efficient.
+      Consider this example: 2^2^20;
+         2^2^20 is represented by 32769 Units and 315653 digits.
+         Digit by digit, we do about 315653 long divisions as the 32769 Units
+         reduce to zero. So, the total number of divides is approximated by
+         the integral from 0 to 315653 of -(32769 / 315653) * x + 32769.
+         We get 32769 * 315653 / 2 or about 5171816578 divides. Five BILLION.
+         2^2^20 is represented by only 35073 groups of 9 digits.
+         We take the integral from 0 to 35073 of -(32769 / 35073) * x + 32769.
+         This comes out to 32769 * 35073 / 2, and we add the 9 * 35073
+         divisions needed to unpack each of those groups, for a total of
+         32787 * 35073 / 2 or about 574969225 divides. We have decreased the
+         number of divides by almost an order of magnitude.
+
+      That is still quadratic, though, so only small pieces are done that
+      way. A big number is split in half by dividing by base^k, where k is
+      the number of digits in the bottom half, and each half is written out
+      on its own: the top half, then the bottom padded to k digits. The
+      base^k come from squaring the packing power, so there are only a few
+      of them, and they are shared all the way down. The division is better
+      at this than the divide by one Unit, and it leaves half the work for
+      each half.
+
+      Everything is written with a fixed width, so the top is written as
+      wide as the number could possibly be, and the extra leading zeros are
+      dropped on the way out.
+
+      fromString() is the same thing backwards: the two halves of a long
+      string are read on their own, and put together with a multiply.
+
+      When Parallel allows it, the halves of a big enough number are done
+      on different threads. Then everything is in one buffer, and each
+      thread fills in its own part of it. Every piece handed to another
+      thread gets its own copies of the numbers it uses, as the BitHolders
+      can't be shared between threads.
+    */
+    /*
+      The value of each character as a digit, or -1 if it isn't one. This
+      only handles ASCII, as fromString() always has.
+    */
+   static const signed char digitValue [256] =
     {
-      fromString(src.c_str(), base);
-    }
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+       0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+      -1, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+      25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, -1, -1, -1, -1, -1,
+      -1, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+      25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+    };
 
-   void Integer::fromString (const char * src, int base)
+    /*
+      This is the packing loop that used to be all of fromString(), for
+      count characters that have already been checked to be digits.
+    */
+   static void pack (BitField & dest, const char * src, long count, int base)
     {
       int curchar, digits;
       Unit fatdigit, power;
-      const char * iter = src;
-      bool done = false;
 
-      if ((base < 2) || (base > 36)) return;
+      dest = BitField();
 
-      if (*iter == '-')
-       {
-         Sign = true;
-         iter++;
-       }
-      else if (*iter == '+')
-       {
-         Sign = false;
-         iter++;
-       }
-      else Sign = false;
-
-      Digits = BitField();
-
-       /*
-         This digit packing algorithm should save alot of time for big
-         numbers, and shouldn't add appreciable time to small numbers.
-       */
-      for (; !done && (*iter != '\0');)
+      while (count > 0)
        {
          digits = maxdigits[base - 2];
          fatdigit = 0;
          power = 1;
 
-         for (; (*iter != '\0') && digits; iter++, digits--)
+         for (; count && digits; src++, count--, digits--)
           {
-            curchar = *iter;
-
-            if ((curchar >= '0') && (curchar <= '9')) //Only handles ASCII
-               curchar = curchar - '0';
-            else if ((curchar >= 'A') && (curchar <= 'Z'))
-               curchar = curchar - 'A' + 10;
-            else if ((curchar >= 'a') && (curchar <= 'z'))
-               curchar = curchar - 'a' + 10;
-            else
-             {
-               done = true;
-               break;
-             }
+            curchar = digitValue[(unsigned char) *src];
 
              /*
                Adopt the bc model, so that 'zzz' is the largest 3 digit number
@@ -645,93 +862,708 @@ namespace BigInt
             power *= base;
           }
 
-         Digits *= power;
-         Digits += fatdigit;
+         dest *= power;
+         dest += fatdigit;
        }
+    }
 
-      if (isZero()) Sign = false;
+
+
+   class Integer::Digitizer
+    {
+      private:
+          // Pieces of this many packed digits or less are done the old way.
+         long Small;
+
+         int Base;
+         const char * Table;
+         Integer_Writer Writer;
+         void * Context;
+
+         std::vector<Integer> Powers; // Powers[i] is Base^Widths[i]
+         std::vector<long> Widths;
+
+         char Buffer [1024];
+         std::vector<char> Scratch; // For digits() to convert into
+         size_t Used;
+         long Skip; // How many leading zeros may be dropped
+         bool Failed;
+
+         class Part;
+
+         void grow (long);
+         long most (const Integer &) const;
+         size_t level (long) const;
+         bool parallel (long) const;
+
+         void put (const char *, size_t);
+         void digits (const Integer &, long);
+
+         void convert (char *, const Integer &, long) const;
+         void fill (char *, const Integer &, long,
+            const std::vector<Integer> &) const;
+
+         void read (Integer &, const char *, long,
+            const std::vector<Integer> &) const;
+
+      public:
+         Digitizer (int, const char * table = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+            Integer_Writer writer = NULL, void * context = NULL);
+
+         bool write (const Integer &, long);
+         void fill (std::string &, const Integer &);
+         void read (Integer &, const char *, long);
+    };
+
+    /*
+      The half of a number that another thread does, with its own copies of
+      the Powers it needs.
+    */
+   class Integer::Digitizer::Part
+    {
+      public:
+         const Digitizer * Owner;
+         std::vector<Integer> Powers;
+         Integer Number;
+         char * Out;
+         const char * In;
+         long Width;
+
+         Part (const Digitizer * owner, const std::vector<Integer> & powers,
+            size_t levels) : Owner (owner), Out (NULL), In (NULL), Width (0)
+          {
+            for (size_t i = 0; i < levels; i++)
+             {
+               Powers.push_back(powers[i]);
+               Powers.back().Digits.unshare();
+             }
+          }
+
+         static void fill (void * part)
+          {
+            Part * self = (Part *) part;
+            self->Owner->fill(self->Out, self->Number, self->Width, self->Powers);
+          }
+
+         static void read (void * part)
+          {
+            Part * self = (Part *) part;
+            self->Owner->read(self->Number, self->In, self->Width, self->Powers);
+          }
+    };
+
+   Integer::Digitizer::Digitizer (int base, const char * table,
+      Integer_Writer writer, void * context) :
+      Small (Integer::thresholds.Convert), Base (base), Table (table), Writer (writer),
+      Context (context), Used (0), Skip (0), Failed (false)
+    {
+    }
+
+    /*
+      Make sure there are Powers for splitting something this wide.
+      Small numbers don't need any.
+    */
+   void Integer::Digitizer::grow (long width)
+    {
+      if (Widths.empty() && (width > Small * maxdigits[Base - 2]))
+       {
+         Widths.push_back(maxdigits[Base - 2]);
+         Powers.push_back(Integer(powers[Base - 2]));
+       }
+      while (!Widths.empty() && (2 * Widths.back() < width))
+       {
+         Powers.push_back(Powers.back() * Powers.back());
+         Widths.push_back(2 * Widths.back());
+       }
+    }
+
+    // There are fewer than bits / log2(Base) + 1 digits.
+   long Integer::Digitizer::most (const Integer & src) const
+    {
+      return (long) ((double) src.bitLength() *
+         (std::log(2.0) / std::log((double) Base))) + 2;
+    }
+
+    // Split at the biggest power that leaves the top no narrower.
+   size_t Integer::Digitizer::level (long width) const
+    {
+      size_t result;
+
+      for (result = 0; (result + 1 < Widths.size()) &&
+         (2 * Widths[result + 1] < width + Widths[0]); result++) ;
+
+      return result;
+    }
+
+   bool Integer::Digitizer::parallel (long width) const
+    {
+      return (Parallel::threads() > 1) &&
+         (width >= Parallel::getCutoff() * maxdigits[Base - 2]);
     }
 
+   void Integer::Digitizer::put (const char * src, size_t count)
+    {
+      while ((Skip > 0) && (count > 0) && (*src == '0'))
+       {
+         src++;
+         count--;
+         Skip--;
+       }
+      if (count > 0) Skip = 0;
+
+      while ((count > 0) && !Failed)
+       {
+         size_t some = std::min(count, sizeof(Buffer) - Used);
 
+         std::memcpy(Buffer + Used, src, some);
+         Used += some;
+         src += some;
+         count -= some;
+
+         if (Used == sizeof(Buffer))
+          {
+            Failed = !Writer(Buffer, Used, Context);
+            Used = 0;
+          }
+       }
+    }
+
+   void Integer::Digitizer::digits (const Integer & src, long width)
+    {
+      Integer high, low;
+      size_t at;
+
+      if (Failed) return;
+
+      if (width <= Small * maxdigits[Base - 2])
+       {
+         if (Scratch.size() < (size_t) width) Scratch.resize(width);
+         convert(&Scratch[0], src, width);
+         put(&Scratch[0], width);
+         return;
+       }
+      if (src.isZero())
+       {
+         char zeros [64];
+         std::memset(zeros, '0', sizeof(zeros));
+         for (; width > 0; width -= (long) sizeof(zeros))
+            put(zeros, std::min(width, (long) sizeof(zeros)));
+         return;
+       }
+
+      Stats::chose(Stats::CONVERT_SPLIT, src.Digits.length());
+      at = level(width);
+      Integer::divmod(src, Powers[at], high, low);
+      digits(high, width - Widths[at]);
+      digits(low, Widths[at]);
+    }
 
     /*
-      Digit packing is NECESSARY for toString to be efficient.
-      Consider this example: 2^2^20;
-         2^2^20 is represented by 32769 Units and 315653 digits.
-         Digit by digit, we do about 315653 long divisions as the 32769 Units
-         reduce to zero. So, the total number of divides is approximated by
-         the integral from 0 to 315653 of -(32769 / 315653) * x + 32769.
-         We get 32769 * 315653 / 2 or about 5171816578 divides. Five BILLION.
-         2^2^20 is represented by only 35073 groups of 9 digits.
-         We take the integral from 0 to 35073 of -(32769 / 35073) * x + 32769.
-         This comes out to 32769 * 35073 / 2, and we add the 9 * 35073
-         divisions needed to unpack each of those groups, for a total of
-         32787 * 35073 / 2 or about 574969225 divides. We have decreased the
-         number of divides by almost an order of magnitude.
+      The old algorithm, on a piece small enough to do that way.
     */
-   std::string Integer::toString (int base) const
+   void Integer::Digitizer::convert (char * dest, const Integer & src,
+      long width) const
     {
-      std::string result;
-      BitField cpy (Digits);
+      BitField cpy (src.Digits);
+      long i = width - 1;
       Unit digit;
-      char table [] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ", * temp = NULL;
-      int i, d;
-      const int buffsize = 2048;
+      int d;
+
+      Stats::chose(Stats::CONVERT_SHORT, src.Digits.length());
+      while (!cpy.isZero())
+       {
+         digit = (cpy /= powers[Base - 2]);
+         for (d = maxdigits[Base - 2]; d && (i >= 0); d--, i--)
+          {
+            dest[i] = Table[digit % Base];
+            digit /= Base;
+          }
+       }
+      for (; i >= 0; i--) dest[i] = '0';
+    }
+
+   void Integer::Digitizer::fill (char * dest, const Integer & src, long width,
+      const std::vector<Integer> & powers) const
+    {
+      Integer high, low;
+      int threads;
+      size_t at;
 
-      if ((base < 2) || (base > 36))
+      if (width <= Small * maxdigits[Base - 2])
        {
-         result = "";
+         convert(dest, src, width);
+         return;
        }
-      else if (isZero())
+      if (src.isZero())
        {
-         result = "0";
+         std::memset(dest, '0', width);
+         return;
        }
-      else
+
+      Stats::chose(Stats::CONVERT_SPLIT, src.Digits.length());
+      at = level(width);
+      Integer::divmod(src, powers[at], high, low);
+
+      if (parallel(width))
        {
-         temp = new char [buffsize];
-         temp [buffsize - 1] = '\0';
-         i = buffsize - 2;
-         while (!cpy.isZero())
+         Part part (this, powers, at + 1);
+         part.Number = high;
+         part.Number.Digits.unshare();
+         part.Out = dest;
+         part.Width = width - Widths[at];
+
+         threads = Parallel::threads();
+         Parallel::Task task (Part::fill, &part, threads / 2);
           {
-            digit = (cpy /= powers[base - 2]);
-            d = maxdigits[base - 2];
+            Parallel::Limit limit (threads - threads / 2);
+            fill(dest + part.Width, low, Widths[at], powers);
+          }
+         task.wait();
+       }
+      else
+       {
+         fill(dest, high, width - Widths[at], powers);
+         fill(dest + width - Widths[at], low, Widths[at], powers);
+       }
+    }
 
-            while (d--)
-             {
-               temp[i--] = table[digit % base];
-               digit /= base;
-               if (i == -1)
-                {
-                  if (cpy.isZero() && (digit == 0))
-                   {
-                     i++;
-                     while (temp[i] == '0') i++;
-                     result = (temp + i) + result;
-                     i = buffsize - 2;
-                     break;
-                   }
-                  else
-                   {
-                     result = temp + result;
-                     i = buffsize - 2;
-                   }
-                }
-             }
+   bool Integer::Digitizer::write (const Integer & src, long width)
+    {
+      long wide = std::max(most(src), width);
+
+      Skip = wide - std::max(width, 1L);
+      grow(wide);
+
+      digits(src, wide);
+
+      if (!Failed && (Used > 0)) Failed = !Writer(Buffer, Used, Context);
+      Used = 0;
+
+      return !Failed;
+    }
+
+    /*
+      The whole number into dest, after a sign if src has one, using all
+      the threads we are allowed.
+    */
+   void Integer::Digitizer::fill (std::string & dest, const Integer & src)
+    {
+      long wide = most(src);
+      size_t start = src.isSigned() ? 1 : 0, lead;
+
+      grow(wide);
+      Limbs::arithmeticKernel(); // Before the threads race to pick them
+      Limbs::bitwiseKernel();
+
+      dest.assign(start + wide, '-');
+      fill(&dest[start], BigInt::abs(src), wide, Powers);
+
+      for (lead = start; (lead + 1 < dest.length()) && (dest[lead] == '0'); lead++) ;
+      dest.erase(start, lead - start);
+    }
+
+   void Integer::Digitizer::read (Integer & dest, const char * src,
+      long count, const std::vector<Integer> & powers) const
+    {
+      Integer high, low;
+      int threads;
+      size_t at;
+
+      if (count <= Small * maxdigits[Base - 2])
+       {
+         Stats::chose(Stats::CONVERT_SHORT, count / maxdigits[Base - 2] + 1);
+         pack(dest.Digits, src, count, Base);
+         dest.Sign = false;
+         return;
+       }
+
+      Stats::chose(Stats::CONVERT_SPLIT, count / maxdigits[Base - 2] + 1);
+      at = level(count);
+
+      if (parallel(count))
+       {
+         Part part (this, powers, at + 1);
+         part.In = src;
+         part.Width = count - Widths[at];
+
+         threads = Parallel::threads();
+         Parallel::Task task (Part::read, &part, threads / 2);
+          {
+            Parallel::Limit limit (threads - threads / 2);
+            read(low, src + part.Width, Widths[at], powers);
           }
-         if (i != (buffsize - 2))
+         task.wait();
+
+         high = part.Number;
+       }
+      else
+       {
+         read(high, src, count - Widths[at], powers);
+         read(low, src + count - Widths[at], Widths[at], powers);
+       }
+
+      dest = high * powers[at] + low;
+    }
+
+   void Integer::Digitizer::read (Integer & dest, const char * src, long count)
+    {
+      grow(count);
+      if (parallel(count))
+       {
+         Limbs::arithmeticKernel();
+         Limbs::bitwiseKernel();
+       }
+      read(dest, src, count, Powers);
+    }
+
+
+
+   void Integer::fromString (const std::string & src, int base)
+    {
+      fromString(src.c_str(), base);
+    }
+
+    /*
+      Only the sign is done here, and the digits are counted. Digitizer does
+      the real work.
+    */
+   void Integer::fromString (const char * src, int base)
+    {
+      const char * iter = src;
+      long count;
+      bool sign;
+
+      if ((base < 2) || (base > 36)) return;
+
+      sign = (*iter == '-');
+      if ((*iter == '-') || (*iter == '+')) iter++;
+
+      for (count = 0; digitValue[(unsigned char) iter[count]] >= 0; count++) ;
+
+      if (count <= 2 * maxdigits[base - 2]) pack(Digits, iter, count, base);
+      else
+       {
+         Digitizer in (base);
+         in.read(*this, iter, count);
+       }
+
+      Sign = sign && !isZero();
+    }
+
+
+
+    /*
+      The binary format is described in Integer.hpp. Only the Units are left
+      to BitField, which knows how they are stored.
+    */
+   static const unsigned char IntegerMagic [4] = { 'A', 'P', 'I', 'N' };
+   static const unsigned char IntegerVersion = 1;
+   static const size_t IntegerHeader = 16;
+
+   static unsigned long long readCount (const unsigned char * src)
+    {
+      unsigned long long result = 0;
+      for (int i = 7; i >= 0; i--) result = (result << 8) | src[i];
+      return result;
+    }
+
+   static bool goodHeader (const unsigned char * src)
+    {
+      return (std::memcmp(src, IntegerMagic, 4) == 0) &&
+         (src[4] != 0) && (src[4] <= IntegerVersion) &&
+         ((src[5] & ~1) == 0) && (src[6] == 0) && (src[7] == 0) &&
+         (readCount(src + 8) <= (unsigned long long) LONG_MAX / sizeof(Unit));
+    }
+
+   size_t Integer::serializedSize (void) const
+    {
+      return IntegerHeader + Digits.length() * sizeof(Unit);
+    }
+
+   size_t Integer::serialize (unsigned char * dest) const
+    {
+      unsigned long long units = Digits.length();
+
+      std::memcpy(dest, IntegerMagic, 4);
+      dest[4] = IntegerVersion;
+      dest[5] = Sign ? 1 : 0;
+      dest[6] = dest[7] = 0;
+      for (int i = 0; i < 8; i++) dest[8 + i] = (unsigned char) (units >> (i * 8));
+
+      Digits.exportBytes(dest + IntegerHeader, units * sizeof(Unit));
+
+      return serializedSize();
+    }
+
+   size_t Integer::deserialize (const unsigned char * src, size_t length)
+    {
+      unsigned long long units;
+
+      if ((length < IntegerHeader) || !goodHeader(src)) return 0;
+
+      units = readCount(src + 8);
+      if (units > (length - IntegerHeader) / sizeof(Unit)) return 0;
+
+      Digits.importBytes(src + IntegerHeader, (long) (units * sizeof(Unit)));
+      Sign = (src[5] & 1) && !Digits.isZero();
+
+      return IntegerHeader + units * sizeof(Unit);
+    }
+
+   bool Integer::serialize (std::ostream & dest) const
+    {
+      std::vector<unsigned char> buffer (serializedSize());
+
+      serialize(&buffer[0]);
+      dest.write((const char *) &buffer[0], buffer.size());
+
+      return !dest.fail();
+    }
+
+    /*
+      Read the Units a piece at a time, so that a damaged count that claims a
+      huge number runs into the end of the stream before it runs us out of
+      memory.
+    */
+   bool Integer::deserialize (std::istream & src)
+    {
+      std::vector<unsigned char> buffer (IntegerHeader);
+      size_t total, got;
+
+      if (!src.read((char *) &buffer[0], IntegerHeader) || !goodHeader(&buffer[0]))
+         return false;
+
+      total = IntegerHeader + readCount(&buffer[8]) * sizeof(Unit);
+      for (got = IntegerHeader; got < total; got = buffer.size())
+       {
+         buffer.resize(got + std::min(total - got, (size_t) 1 << 20));
+         if (!src.read((char *) &buffer[got], buffer.size() - got))
+            return false;
+       }
+
+      return deserialize(&buffer[0], total) != 0;
+    }
+
+
+
+    /*
+      Everything is done as a little-endian byte string, which is what
+      BitField deals in. When that's what we were given (or asked for) it's
+      just a copy, otherwise the words get shuffled through a buffer.
+    */
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+   static const bool LittleHost = true;
+#else
+   static const bool LittleHost = false;
+#endif
+
+   static void reorder (unsigned char * dest, const unsigned char * src,
+      size_t count, Integer_Word_Order order, size_t size, bool toLittle)
+    {
+      for (size_t i = 0; i < count; i++)
+       {
+         size_t word = (order == LEAST_SIGNIFICANT_FIRST) ? i : count - 1 - i;
+         for (size_t j = 0; j < size; j++)
           {
-            i++;
-            while (temp[i] == '0') i++;
-            result = (temp + i) + result;
+            size_t little = i * size + j,
+               given = word * size + (LittleHost ? j : size - 1 - j);
+            if (toLittle) dest[little] = src[given];
+            else dest[given] = src[little];
           }
-         if (isSigned()) result = "-" + result;
-         delete [] temp;
-         temp = NULL;
+       }
+    }
+
+   Integer & Integer::importBytes (const void * src, size_t count,
+      Integer_Word_Order order, size_t size)
+    {
+      const unsigned char * in = (const unsigned char *) src;
+
+      Sign = false;
+
+      if ((order == LEAST_SIGNIFICANT_FIRST) && ((size == 1) || LittleHost))
+         Digits.importBytes(in, (long) (count * size));
+      else
+       {
+         std::vector<unsigned char> temp (count * size + 1);
+         reorder(&temp[0], in, count, order, size, true);
+         Digits.importBytes(&temp[0], (long) (count * size));
+       }
+
+      return *this;
+    }
+
+   size_t Integer::exportSize (size_t size) const
+    {
+      if (size == 0) return 0;
+      return (bitLength() + 8 * size - 1) / (8 * size);
+    }
+
+   size_t Integer::exportBytes (void * dest,
+      Integer_Word_Order order, size_t size) const
+    {
+      unsigned char * out = (unsigned char *) dest;
+      size_t count = exportSize(size);
+
+      if (count == 0) return 0;
+
+      if ((order == LEAST_SIGNIFICANT_FIRST) && ((size == 1) || LittleHost))
+         Digits.exportBytes(out, (long) (count * size));
+      else
+       {
+         std::vector<unsigned char> temp (count * size);
+         Digits.exportBytes(&temp[0], (long) (count * size));
+         reorder(out, &temp[0], count, order, size, false);
        }
 
+      return count;
+    }
+
+
+
+   bool Integer::write (Integer_Writer writer, void * context,
+      int base, long width) const
+    {
+      if ((base < 2) || (base > 36)) return false;
+
+      if (isSigned() && !writer("-", 1, context)) return false;
+
+      Digitizer out (base, "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ", writer, context);
+      return out.write(BigInt::abs(*this), width);
+    }
+
+   static bool append (const char * src, size_t count, void * dest)
+    {
+      ((std::string *) dest)->append(src, count);
+      return true;
+    }
+
+   std::string Integer::toString (int base) const
+    {
+      std::string result;
+
+      if ((base < 2) || (base > 36)) return result;
+
+      if ((Parallel::threads() > 1) && (Digits.length() >= Parallel::getCutoff()))
+       {
+         Digitizer out (base);
+         out.fill(result, *this);
+         return result;
+       }
+
+      result.reserve(bitLength() / 3 + 2);
+      write(append, &result, base);
+
       return result;
     }
 
+   static bool insert (const char * src, size_t count, void * dest)
+    {
+      return !((std::ostream *) dest)->write(src, count).fail();
+    }
+
+   std::ostream & operator << (std::ostream & dest, const Integer & src)
+    {
+      static const char upper [] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+      static const char lower [] = "0123456789abcdefghijklmnopqrstuvwxyz";
+      std::ios::fmtflags flags = dest.flags();
+      int base = 10;
+
+      if ((flags & std::ios::basefield) == std::ios::hex) base = 16;
+      else if ((flags & std::ios::basefield) == std::ios::oct) base = 8;
+
+       // Padding needs the whole thing in hand. Let the string do that.
+      if (dest.width() > 0)
+       {
+         std::string temp;
+         if (src.isSigned()) temp = "-";
+         else if (flags & std::ios::showpos) temp = "+";
+         Integer::Digitizer out (base,
+            (flags & std::ios::uppercase) ? upper : lower, append, &temp);
+         out.write(abs(src), 0);
+         return dest << temp;
+       }
+
+      std::ostream::sentry ok (dest);
+      if (!ok) return dest;
+
+      if (src.isSigned()) dest.put('-');
+      else if (flags & std::ios::showpos) dest.put('+');
+
+      Integer::Digitizer out (base,
+         (flags & std::ios::uppercase) ? upper : lower, insert, &dest);
+      if (!out.write(abs(src), 0)) dest.setstate(std::ios::badbit);
+
+      return dest;
+    }
+
+    /*
+      The digits are read in pieces of ParallelProduct, and each piece is put onto the
+      bottom of what we have so far.
+    */
+   std::istream & operator >> (std::istream & src, Integer & dest)
+    {
+      static const size_t ParallelProduct = 4096;
+      std::istream::sentry ok (src);
+      std::string digits;
+      Integer result, scale;
+      bool sign = false, any = false;
+      int base = 10, c, value;
+
+      if (!ok) return src;
+
+      if ((src.flags() & std::ios::basefield) == std::ios::hex) base = 16;
+      else if ((src.flags() & std::ios::basefield) == std::ios::oct) base = 8;
+
+      c = src.peek();
+      if ((c == '-') || (c == '+'))
+       {
+         sign = (c == '-');
+         src.get();
+       }
+
+      digits.reserve(ParallelProduct);
+      for (;;)
+       {
+         c = src.peek();
+
+         value = (c == EOF) ? -1 : digitValue[(unsigned char) c];
+         if (value < 0) value = base;
+
+         if (value < base)
+          {
+            digits += (char) src.get();
+            any = true;
+          }
+
+         if ((digits.length() == ParallelProduct) || ((value >= base) && !digits.empty()))
+          {
+            if (digits.length() == ParallelProduct)
+             {
+               if (scale.isZero())
+                  scale = pow(Integer((long long) base), Integer((long long) ParallelProduct));
+               result *= scale;
+             }
+            else
+               result *= pow(Integer((long long) base),
+                  Integer((long long) digits.length()));
+
+            result += Integer(digits, base);
+            digits.clear();
+          }
+
+         if (value >= base) break;
+       }
+
+      if (!any) src.setstate(std::ios::failbit);
+      else
+       {
+         if (sign) result.negate();
+         dest = result;
+       }
+
+      return src;
+    }
+
 
 
    void Integer::divmod (const Integer & lhs, const Integer & rhs,
@@ -787,6 +1619,7 @@ namespace BigInt
        // Let's do the simple case first.
       if (dr.Digits.length() == 1)
        {
+         Stats::chose(Stats::DIVIDE_SHORT, dd.Digits.length());
          smallr = (dd.Digits /= dr.Digits.getDigit(0));
 
          q.Digits = dd.Digits;
@@ -821,6 +1654,7 @@ namespace BigInt
          139578 - 137982 = 1596
          Quotient = 6978 (69|78) Remainder = 1596
        */
+      Stats::chose(Stats::DIVIDE_LONG, dd.Digits.length());
       q.Digits = BitField();
 
        //we normalize dr so that it's msb is bit 31
@@ -903,17 +1737,17 @@ namespace BigInt
 
       if (rhs.isZero()) return result;
 
+      const long top = rhs.Digits.msb();
       for (long i = 0; /* I moved this down. */ ; i++)
        {
-         if (rhs.Digits.getDigit(i / BitField::bits)
-              & (((Unit)1) << (i % BitField::bits))) result *= temp;
+         if (rhs.Digits.testBit(i)) result *= temp;
 
           /*
             We should get a speed boost putting this test here,
             as we aren't doing one too many multiplications (which matters
             for cases like 2^2^20).
           */
-         if (i == rhs.Digits.msb()) break;
+         if (i == top) break;
 
          temp *= temp;
        }
@@ -962,18 +1796,68 @@ namespace BigInt
 
 
 
+    /*
+      Multiply a list of numbers together, pairing off neighbors so that
+      the big multiplications are between numbers of similar size.
+    */
+   static Integer product (std::vector<Integer> & terms)
+    {
+      if (terms.empty()) return Integer((Unit) 1);
+
+      while (terms.size() > 1)
+       {
+         size_t i, j;
+         for (i = 0, j = 0; i + 1 < terms.size(); i += 2, j++)
+            terms[j] = terms[i] * terms[i + 1];
+         if (i < terms.size()) terms[j++] = terms[i];
+         terms.resize(j);
+       }
+
+      return terms[0];
+    }
+
     /*
       Factorial. Return 0 on negative arg.
+
+      n! is built from its prime factorization. The exponent of p is
+      n/p + n/p^2 + ... (Legendre), and it only decreases as p grows,
+      so the primes are grouped by exponent and each group is raised to
+      its power once.
     */
    Integer fact (const Integer & ofThis)
     {
-      Integer i (ofThis), product ((Unit) 1);
+      Integer i (ofThis), result ((Unit) 1);
 
       if (ofThis.isSigned()) return Integer((Unit) 0);
 
-      while (!(!i)) { product *= i; --i; }
+      if ((ofThis.msb() >= BitField::bits) || (ofThis.getDigit(0) < 32))
+       {
+         while (!(!i)) { result *= i; --i; }
+         return result;
+       }
 
-      return product;
+      const Unit n = ofThis.getDigit(0);
+      std::vector<Integer> terms, group;
+      PrimeSieve primes (2, n + 1);
+      Unit p, e, last = 0;
+
+      for (p = primes.next(); ; p = primes.next())
+       {
+         e = 0;
+         if (p != 0) for (Unit q = n / p; q != 0; q /= p) e += q;
+
+         if ((e != last) && !group.empty())
+          {
+            terms.push_back(pow(product(group), Integer(last)));
+            group.clear();
+          }
+         if (p == 0) break;
+
+         group.push_back(Integer(p));
+         last = e;
+       }
+
+      return product(terms);
     }
 
    Integer permutation (const Integer & items, const Integer & taken)
@@ -1086,8 +1970,7 @@ namespace BigInt
 
       for (long i = temp.msb(); /* I moved this down. */ ; --i)
        {
-         if (temp.getDigit(i / BitField::bits)
-              & (((Unit)1) << (i % BitField::bits))) fibMult(result, one);
+         if (temp.testBit(i)) fibMult(result, one);
 
           /*
             We should get a speed boost putting this test here,
@@ -1204,12 +2087,12 @@ namespace BigInt
 
       temp = mod(base, Mod);
 
+      const long top = nexp.msb();
       for (long i = 0; /* This is in the middle of the loop. */ ; i++)
        {
-         if (nexp.getDigit(i / BitField::bits) & (((Unit)1) << (i % BitField::bits)))
-            result = mod(result * temp, Mod);
+         if (nexp.testBit(i)) result = mod(result * temp, Mod);
 
-         if (i == nexp.msb()) break;
+         if (i == top) break;
 
          temp = mod(temp * temp, Mod);
        }
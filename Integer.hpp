@@ -37,12 +37,42 @@ SUCH DAMAGE.
 #ifndef INTEGER_HPP
 #define INTEGER_HPP
 
+#include <cstddef>
+#include <iosfwd>
 #include <string>
 #include "BitField.hpp"
 
 namespace BigInt
  {
 
+    // The order of the words given to importBytes() and exportBytes().
+   enum Integer_Word_Order
+    {
+      LEAST_SIGNIFICANT_FIRST,
+      MOST_SIGNIFICANT_FIRST
+    };
+
+    /*
+      Integer::write() hands its digits to one of these a piece at a time,
+      along with the void * it was given. Returning false stops it.
+    */
+   typedef bool (*Integer_Writer) (const char *, size_t, void *);
+
+    /*
+      Where Integer changes algorithms, in Units. Multiplication uses
+      Karatsuba once both operands are at least Multiply Units, or Square
+      for a number times itself. Radix conversion splits anything longer
+      than Convert Units in half. The defaults come from Tuned.hpp, if
+      Bench/Tune has made one.
+    */
+   class Integer_Thresholds
+    {
+      public:
+         long Multiply;
+         long Square;
+         long Convert;
+    };
+
    class Integer
     {
 
@@ -50,9 +80,18 @@ namespace BigInt
          BitField Digits;
          bool Sign;
 
+         static Integer_Thresholds thresholds;
+
+         class Digitizer; // Does the work for write(), in Integer.cpp
+
          static Integer adder (const Integer &, const Integer &);
+         static void karatsuba (const Integer &, const Integer &,
+            const Integer &, const Integer &, Integer &, Integer &, Integer &);
 
       public:
+         static Integer_Thresholds getThresholds (void) { return thresholds; }
+         static Integer_Thresholds setThresholds (const Integer_Thresholds &);
+
          Integer ();
          Integer (long long);
          Integer (Unit);
@@ -68,9 +107,57 @@ namespace BigInt
 
          std::string toString (int base = 10) const;
 
+          /*
+            toString(), a piece at a time, for numbers too big to want as one
+            string. There are at least width digits, padded with zeros. This
+            returns false if the base is bad or the writer gave up.
+          */
+         bool write (Integer_Writer, void *, int base = 10, long width = 0) const;
+
          void fromString (const std::string &, int base = 10);
          void fromString (const char *, int base = 10);
 
+          /*
+            A binary format, for saving a number without going through
+            toString(). It is all little-endian:
+               bytes 0-3    "APIN"
+               byte 4       version, currently 1
+               byte 5       flags: bit 0 is the sign
+               bytes 6-7    zero
+               bytes 8-15   the number of Units, n
+               then n 64 bit Units, least significant first
+            The header is 16 bytes so that the Units stay aligned.
+            serialize() writes serializedSize() bytes and returns that.
+            deserialize() returns the number of bytes it used, or zero if it
+            didn't like what it saw, in which case we are left alone.
+          */
+         size_t serializedSize (void) const;
+         size_t serialize (unsigned char *) const;
+         size_t deserialize (const unsigned char *, size_t);
+         bool serialize (std::ostream &) const;
+         bool deserialize (std::istream &);
+
+          /*
+            The magnitude as an array of count words of size bytes each,
+            for talking to things that think in bytes. The words are in the
+            given order, and the bytes of each word are in this machine's
+            order, so an array of uint32_t is size 4. With size 1, it's a
+            plain byte string. There's no sign: importBytes() makes a
+            positive number, and exportBytes() ignores it.
+
+            exportSize() is the number of words exportBytes() writes, which
+            is zero for zero. exportBytes() returns that same number.
+          */
+         Integer & importBytes (const void *, size_t count,
+            Integer_Word_Order order = LEAST_SIGNIFICANT_FIRST, size_t size = 1);
+         size_t exportSize (size_t size = 1) const;
+         size_t exportBytes (void *,
+            Integer_Word_Order order = LEAST_SIGNIFICANT_FIRST, size_t size = 1) const;
+
+         friend std::ostream & operator << (std::ostream &, const Integer &);
+
+         friend bool mapInteger (const char *, Integer &, unsigned long long);
+
          Integer & negate (void);
          Integer & abs (void);
          Integer & copySign (const Integer &);
@@ -115,6 +202,26 @@ namespace BigInt
 
          long toInt (void) const; //Not perfect, but not terrible.
          long msb (void) const { return Digits.msb(); }
+
+          /*
+            Like msb(), these look at the magnitude only. lowestSetBit() is
+            -1 for zero, and bitLength() is msb() + 1, so zero for zero.
+          */
+         long popcount (void) const { return Digits.popcount(); }
+         long lowestSetBit (void) const { return Digits.lsb(); }
+         long bitLength (void) const { return Digits.msb() + 1; }
+         bool testBit (long bit) const { return Digits.testBit(bit); }
+
+          /*
+            Bit and byte slices of the magnitude: getBits(offset, width) and
+            setBits(offset, width, value), where setBits uses the low width
+            bits of value's magnitude. The sign is left alone.
+          */
+         Integer getBits (long, long) const;
+         Integer & setBits (long, long, const Integer &);
+         Unit getByte (long) const;
+         Integer & setByte (long, Unit);
+
          Unit getDigit (long digit) const { return Digits.getDigit(digit); }
 
          int compare (const Integer &) const;
@@ -148,6 +255,14 @@ namespace BigInt
    Integer operator << (const Integer &, const Integer &);
    Integer operator >> (const Integer &, const Integer &);
 
+    /*
+      These go through write() and read a piece at a time, so a big number
+      never has to be one big string. hex and oct are honored, as are
+      showpos and uppercase on the way out.
+    */
+   std::ostream & operator << (std::ostream &, const Integer &);
+   std::istream & operator >> (std::istream &, Integer &);
+
    bool operator > (const Integer &, const Integer &);
    bool operator < (const Integer &, const Integer &);
    bool operator >= (const Integer &, const Integer &);
@@ -0,0 +1,678 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+#include "Limbs.hpp"
+#include "Stats.hpp"
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+ #define LIMBS_X86
+ #include <immintrin.h>
+#endif
+
+namespace BigInt
+ {
+
+   namespace Limbs
+    {
+
+      typedef void (*Binary) (Unit *, const Unit *, const Unit *, long);
+      typedef void (*Unary) (Unit *, const Unit *, long);
+      typedef Unit (*Carry) (Unit *, const Unit *, const Unit *, long);
+      typedef Unit (*Scale) (Unit *, const Unit *, long, Unit);
+
+       /*
+         Everything in this repository already leans on GCC's 128 bit
+         type to get at the high half of a product.
+       */
+      typedef unsigned __int128 Wide;
+
+       /*
+         The portable versions. These are the loops that BitField has
+         always had.
+       */
+      static void andPortable (Unit * r, const Unit * a, const Unit * b,
+         long n)
+       {
+         for (long i = 0; i < n; i++) r[i] = a[i] & b[i];
+       }
+
+      static void iorPortable (Unit * r, const Unit * a, const Unit * b,
+         long n)
+       {
+         for (long i = 0; i < n; i++) r[i] = a[i] | b[i];
+       }
+
+      static void xorPortable (Unit * r, const Unit * a, const Unit * b,
+         long n)
+       {
+         for (long i = 0; i < n; i++) r[i] = a[i] ^ b[i];
+       }
+
+      static void comPortable (Unit * r, const Unit * a, long n)
+       {
+         for (long i = 0; i < n; i++) r[i] = ~a[i];
+       }
+
+       /*
+         And the arithmetic, which is what BitField used to do inline.
+       */
+      static Unit addPortable (Unit * r, const Unit * a, const Unit * b,
+         long n)
+       {
+         Wide temp;
+         Unit carry = 0;
+
+         for (long i = 0; i < n; i++)
+          {
+            temp = (Wide) a[i] + b[i] + carry;
+            r[i] = (Unit) temp;
+            carry = (Unit) (temp >> 64);
+          }
+
+         return carry;
+       }
+
+      static Unit subPortable (Unit * r, const Unit * a, const Unit * b,
+         long n)
+       {
+         Wide temp;
+         Unit borrow = 0;
+
+         for (long i = 0; i < n; i++)
+          {
+            temp = (Wide) a[i] - b[i] - borrow;
+            r[i] = (Unit) temp;
+            borrow = (Unit) (temp >> 64) & 1;
+          }
+
+         return borrow;
+       }
+
+      static Unit mulPortable (Unit * r, const Unit * a, long n, Unit b)
+       {
+         Wide temp;
+         Unit carry = 0;
+
+         for (long i = 0; i < n; i++)
+          {
+            temp = (Wide) a[i] * b + carry;
+            r[i] = (Unit) temp;
+            carry = (Unit) (temp >> 64);
+          }
+
+         return carry;
+       }
+
+      static Unit addMulPortable (Unit * r, const Unit * a, long n, Unit b)
+       {
+         Wide temp;
+         Unit carry = 0;
+
+         for (long i = 0; i < n; i++)
+          {
+            temp = (Wide) a[i] * b + r[i] + carry;
+            r[i] = (Unit) temp;
+            carry = (Unit) (temp >> 64);
+          }
+
+         return carry;
+       }
+
+#ifdef LIMBS_X86
+
+       /*
+         The vector versions all have the same shape: single Units until
+         the result is aligned, two vectors per trip through the main loop,
+         then one, then whatever Units are left. new [] only promises 16
+         bytes of alignment, and a wide access that splits a cache line
+         costs about as much as two, so aligning the stores matters. The
+         loads are left unaligned, though they usually line up as well.
+       */
+ #define BINARY_KERNEL(NAME, TARGET, VEC, STEP, LOAD, STORE, OP, SCALAR) \
+      __attribute__((target(TARGET))) \
+      static void NAME (Unit * r, const Unit * a, const Unit * b, long n) \
+       { \
+         long i = 0; \
+         for (; (i < n) && ((uintptr_t) (r + i) % sizeof(VEC)); i++) \
+            r[i] = a[i] SCALAR b[i]; \
+         for (; i + 2 * STEP <= n; i += 2 * STEP) \
+          { \
+            VEC x0 = OP(LOAD(a + i), LOAD(b + i)); \
+            VEC x1 = OP(LOAD(a + i + STEP), LOAD(b + i + STEP)); \
+            STORE(r + i, x0); \
+            STORE(r + i + STEP, x1); \
+          } \
+         for (; i + STEP <= n; i += STEP) \
+            STORE(r + i, OP(LOAD(a + i), LOAD(b + i))); \
+         for (; i < n; i++) r[i] = a[i] SCALAR b[i]; \
+       }
+
+ #define UNARY_KERNEL(NAME, TARGET, VEC, STEP, LOAD, STORE, XOR, ONES) \
+      __attribute__((target(TARGET))) \
+      static void NAME (Unit * r, const Unit * a, long n) \
+       { \
+         const VEC ones = ONES; \
+         long i = 0; \
+         for (; (i < n) && ((uintptr_t) (r + i) % sizeof(VEC)); i++) \
+            r[i] = ~a[i]; \
+         for (; i + 2 * STEP <= n; i += 2 * STEP) \
+          { \
+            VEC x0 = XOR(LOAD(a + i), ones); \
+            VEC x1 = XOR(LOAD(a + i + STEP), ones); \
+            STORE(r + i, x0); \
+            STORE(r + i + STEP, x1); \
+          } \
+         for (; i + STEP <= n; i += STEP) \
+            STORE(r + i, XOR(LOAD(a + i), ones)); \
+         for (; i < n; i++) r[i] = ~a[i]; \
+       }
+
+ #define LOAD128(p) _mm_loadu_si128((const __m128i *) (p))
+ #define STORE128(p, x) _mm_storeu_si128((__m128i *) (p), (x))
+ #define LOAD256(p) _mm256_loadu_si256((const __m256i *) (p))
+ #define STORE256(p, x) _mm256_storeu_si256((__m256i *) (p), (x))
+ #define LOAD512(p) _mm512_loadu_si512((const void *) (p))
+ #define STORE512(p, x) _mm512_storeu_si512((void *) (p), (x))
+
+      BINARY_KERNEL(andSSE2, "sse2", __m128i, 2, LOAD128, STORE128,
+         _mm_and_si128, &)
+      BINARY_KERNEL(iorSSE2, "sse2", __m128i, 2, LOAD128, STORE128,
+         _mm_or_si128, |)
+      BINARY_KERNEL(xorSSE2, "sse2", __m128i, 2, LOAD128, STORE128,
+         _mm_xor_si128, ^)
+      UNARY_KERNEL(comSSE2, "sse2", __m128i, 2, LOAD128, STORE128,
+         _mm_xor_si128, _mm_set1_epi32(-1))
+
+      BINARY_KERNEL(andAVX2, "avx2", __m256i, 4, LOAD256, STORE256,
+         _mm256_and_si256, &)
+      BINARY_KERNEL(iorAVX2, "avx2", __m256i, 4, LOAD256, STORE256,
+         _mm256_or_si256, |)
+      BINARY_KERNEL(xorAVX2, "avx2", __m256i, 4, LOAD256, STORE256,
+         _mm256_xor_si256, ^)
+      UNARY_KERNEL(comAVX2, "avx2", __m256i, 4, LOAD256, STORE256,
+         _mm256_xor_si256, _mm256_set1_epi32(-1))
+
+      BINARY_KERNEL(andAVX512, "avx512f", __m512i, 8, LOAD512, STORE512,
+         _mm512_and_si512, &)
+      BINARY_KERNEL(iorAVX512, "avx512f", __m512i, 8, LOAD512, STORE512,
+         _mm512_or_si512, |)
+      BINARY_KERNEL(xorAVX512, "avx512f", __m512i, 8, LOAD512, STORE512,
+         _mm512_xor_si512, ^)
+      UNARY_KERNEL(comAVX512, "avx512f", __m512i, 8, LOAD512, STORE512,
+         _mm512_xor_si512, _mm512_set1_epi32(-1))
+
+ #undef BINARY_KERNEL
+ #undef UNARY_KERNEL
+
+
+
+       /*
+         Addition and subtraction are one carry chain, which ADC handles
+         as well as anything can. These only need plain x86-64, but GCC
+         won't make an ADC chain out of the 128 bit arithmetic above.
+       */
+      static Unit addADX (Unit * r, const Unit * a, const Unit * b, long n)
+       {
+         unsigned char carry = 0;
+         unsigned long long t0, t1, t2, t3;
+         long i = 0;
+
+         for (; i + 4 <= n; i += 4)
+          {
+            carry = _addcarry_u64(carry, a[i], b[i], &t0);
+            carry = _addcarry_u64(carry, a[i + 1], b[i + 1], &t1);
+            carry = _addcarry_u64(carry, a[i + 2], b[i + 2], &t2);
+            carry = _addcarry_u64(carry, a[i + 3], b[i + 3], &t3);
+            r[i] = t0;
+            r[i + 1] = t1;
+            r[i + 2] = t2;
+            r[i + 3] = t3;
+          }
+         for (; i < n; i++)
+          {
+            carry = _addcarry_u64(carry, a[i], b[i], &t0);
+            r[i] = t0;
+          }
+
+         return carry;
+       }
+
+      static Unit subADX (Unit * r, const Unit * a, const Unit * b, long n)
+       {
+         unsigned char borrow = 0;
+         unsigned long long t0, t1, t2, t3;
+         long i = 0;
+
+         for (; i + 4 <= n; i += 4)
+          {
+            borrow = _subborrow_u64(borrow, a[i], b[i], &t0);
+            borrow = _subborrow_u64(borrow, a[i + 1], b[i + 1], &t1);
+            borrow = _subborrow_u64(borrow, a[i + 2], b[i + 2], &t2);
+            borrow = _subborrow_u64(borrow, a[i + 3], b[i + 3], &t3);
+            r[i] = t0;
+            r[i + 1] = t1;
+            r[i + 2] = t2;
+            r[i + 3] = t3;
+          }
+         for (; i < n; i++)
+          {
+            borrow = _subborrow_u64(borrow, a[i], b[i], &t0);
+            r[i] = t0;
+          }
+
+         return borrow;
+       }
+
+       /*
+         Multiplication by a Unit is where ADX pays. MULX doesn't touch
+         the flags, and ADCX and ADOX carry through CF and OF separately,
+         so addMul1 runs two carry chains at once: one adding the high
+         half of the last product into the low half of this one, the
+         other adding that into r. GCC won't emit ADCX/ADOX from the
+         intrinsics, so the blocks of four are assembly. Each block folds
+         both carries into the high Unit before the loop counter can
+         clobber the flags. That can't overflow, as the high half of a
+         product is at most 2^64 - 2.
+       */
+      __attribute__((target("adx,bmi2")))
+      static Unit mulADX (Unit * r, const Unit * a, long n, Unit b)
+       {
+         Unit carry = 0, l0, h0, l1, h1, z;
+         long i = 0;
+
+         for (; i + 4 <= n; i += 4)
+          {
+            __asm__ (
+               "xorl %k[z], %k[z]\n\t"
+               "mulx   (%[a]), %[l0], %[h0]\n\t"
+               "mulx  8(%[a]), %[l1], %[h1]\n\t"
+               "adcx %[c], %[l0]\n\t"
+               "movq %[l0],   (%[r])\n\t"
+               "adcx %[h0], %[l1]\n\t"
+               "movq %[l1],  8(%[r])\n\t"
+               "mulx 16(%[a]), %[l0], %[h0]\n\t"
+               "mulx 24(%[a]), %[l1], %[c]\n\t"
+               "adcx %[h1], %[l0]\n\t"
+               "movq %[l0], 16(%[r])\n\t"
+               "adcx %[h0], %[l1]\n\t"
+               "movq %[l1], 24(%[r])\n\t"
+               "adcx %[z], %[c]\n\t"
+               : [c] "+&r" (carry), [l0] "=&r" (l0), [h0] "=&r" (h0),
+                 [l1] "=&r" (l1), [h1] "=&r" (h1), [z] "=&r" (z)
+               : [a] "r" (a + i), [r] "r" (r + i), "d" (b)
+               : "cc", "memory");
+          }
+
+         for (; i < n; i++)
+          {
+            Wide temp = (Wide) a[i] * b + carry;
+            r[i] = (Unit) temp;
+            carry = (Unit) (temp >> 64);
+          }
+
+         return carry;
+       }
+
+      __attribute__((target("adx,bmi2")))
+      static Unit addMulADX (Unit * r, const Unit * a, long n, Unit b)
+       {
+         Unit carry = 0, l0, h0, l1, h1, z;
+         long i = 0;
+
+         for (; i + 4 <= n; i += 4)
+          {
+            __asm__ (
+               "xorl %k[z], %k[z]\n\t"
+               "mulx   (%[a]), %[l0], %[h0]\n\t"
+               "adox %[c], %[l0]\n\t"
+               "adcx   (%[r]), %[l0]\n\t"
+               "movq %[l0],   (%[r])\n\t"
+               "mulx  8(%[a]), %[l1], %[h1]\n\t"
+               "adox %[h0], %[l1]\n\t"
+               "adcx  8(%[r]), %[l1]\n\t"
+               "movq %[l1],  8(%[r])\n\t"
+               "mulx 16(%[a]), %[l0], %[h0]\n\t"
+               "adox %[h1], %[l0]\n\t"
+               "adcx 16(%[r]), %[l0]\n\t"
+               "movq %[l0], 16(%[r])\n\t"
+               "mulx 24(%[a]), %[l1], %[c]\n\t"
+               "adox %[h0], %[l1]\n\t"
+               "adcx 24(%[r]), %[l1]\n\t"
+               "movq %[l1], 24(%[r])\n\t"
+               "adox %[z], %[c]\n\t"
+               "adcx %[z], %[c]\n\t"
+               : [c] "+&r" (carry), [l0] "=&r" (l0), [h0] "=&r" (h0),
+                 [l1] "=&r" (l1), [h1] "=&r" (h1), [z] "=&r" (z)
+               : [a] "r" (a + i), [r] "r" (r + i), "d" (b)
+               : "cc", "memory");
+          }
+
+         for (; i < n; i++)
+          {
+            Wide temp = (Wide) a[i] * b + r[i] + carry;
+            r[i] = (Unit) temp;
+            carry = (Unit) (temp >> 64);
+          }
+
+         return carry;
+       }
+
+#endif /* LIMBS_X86 */
+
+
+
+       /*
+         Dispatch. The pointers start out at resolvers, which pick the
+         kernels and then forward the call. As they are constant
+         initialized, this works even during static initialization.
+       */
+      static void andResolve (Unit *, const Unit *, const Unit *, long);
+      static void iorResolve (Unit *, const Unit *, const Unit *, long);
+      static void xorResolve (Unit *, const Unit *, const Unit *, long);
+      static void comResolve (Unit *, const Unit *, long);
+      static Unit addResolve (Unit *, const Unit *, const Unit *, long);
+      static Unit subResolve (Unit *, const Unit *, const Unit *, long);
+      static Unit mulResolve (Unit *, const Unit *, long, Unit);
+      static Unit addMulResolve (Unit *, const Unit *, long, Unit);
+
+      static Binary andKernel = andResolve;
+      static Binary iorKernel = iorResolve;
+      static Binary xorKernel = xorResolve;
+      static Unary comKernel = comResolve;
+      static Kernel bitwise = PORTABLE;
+
+      static Carry addKernel = addResolve;
+      static Carry subKernel = subResolve;
+      static Scale mulKernel = mulResolve;
+      static Scale addMulKernel = addMulResolve;
+      static Kernel arithmetic = PORTABLE;
+
+      const char * kernelName (Kernel which)
+       {
+         switch (which)
+          {
+            case SSE2: return "SSE2";
+            case AVX2: return "AVX2";
+            case AVX512: return "AVX-512";
+            case ADX: return "ADX";
+            default: return "portable";
+          }
+       }
+
+      bool hasKernel (Kernel which)
+       {
+#ifdef LIMBS_X86
+         __builtin_cpu_init();
+         switch (which)
+          {
+            case PORTABLE: return true;
+            case SSE2: return __builtin_cpu_supports("sse2");
+            case AVX2: return __builtin_cpu_supports("avx2");
+            case AVX512: return __builtin_cpu_supports("avx512f");
+            case ADX: return __builtin_cpu_supports("adx") &&
+               __builtin_cpu_supports("bmi2");
+          }
+         return false;
+#else
+         return which == PORTABLE;
+#endif
+       }
+
+      Kernel useBitwiseKernel (Kernel which)
+       {
+         if (which > AVX512) which = AVX512;
+         while ((which != PORTABLE) && !hasKernel(which))
+            which = (Kernel) (which - 1);
+
+         switch (which)
+          {
+#ifdef LIMBS_X86
+            case SSE2:
+               andKernel = andSSE2;
+               iorKernel = iorSSE2;
+               xorKernel = xorSSE2;
+               comKernel = comSSE2;
+               break;
+            case AVX2:
+               andKernel = andAVX2;
+               iorKernel = iorAVX2;
+               xorKernel = xorAVX2;
+               comKernel = comAVX2;
+               break;
+            case AVX512:
+               andKernel = andAVX512;
+               iorKernel = iorAVX512;
+               xorKernel = xorAVX512;
+               comKernel = comAVX512;
+               break;
+#endif
+            default:
+               andKernel = andPortable;
+               iorKernel = iorPortable;
+               xorKernel = xorPortable;
+               comKernel = comPortable;
+               which = PORTABLE;
+               break;
+          }
+
+         bitwise = which;
+         return which;
+       }
+
+      Kernel bitwiseKernel (void)
+       {
+         if (andKernel == andResolve) useBitwiseKernel(AVX512);
+         return bitwise;
+       }
+
+      Kernel useArithmeticKernel (Kernel which)
+       {
+#ifdef LIMBS_X86
+         if ((which == ADX) && hasKernel(ADX))
+          {
+            addKernel = addADX;
+            subKernel = subADX;
+            mulKernel = mulADX;
+            addMulKernel = addMulADX;
+            arithmetic = ADX;
+            return ADX;
+          }
+#endif
+         addKernel = addPortable;
+         subKernel = subPortable;
+         mulKernel = mulPortable;
+         addMulKernel = addMulPortable;
+         arithmetic = PORTABLE;
+         return PORTABLE;
+       }
+
+      Kernel arithmeticKernel (void)
+       {
+         if (addKernel == addResolve) useArithmeticKernel(ADX);
+         return arithmetic;
+       }
+
+      static void andResolve (Unit * r, const Unit * a, const Unit * b,
+         long n)
+       {
+         useBitwiseKernel(AVX512);
+         andKernel(r, a, b, n);
+       }
+
+      static void iorResolve (Unit * r, const Unit * a, const Unit * b,
+         long n)
+       {
+         useBitwiseKernel(AVX512);
+         iorKernel(r, a, b, n);
+       }
+
+      static void xorResolve (Unit * r, const Unit * a, const Unit * b,
+         long n)
+       {
+         useBitwiseKernel(AVX512);
+         xorKernel(r, a, b, n);
+       }
+
+      static void comResolve (Unit * r, const Unit * a, long n)
+       {
+         useBitwiseKernel(AVX512);
+         comKernel(r, a, n);
+       }
+
+      static Unit addResolve (Unit * r, const Unit * a, const Unit * b,
+         long n)
+       {
+         useArithmeticKernel(ADX);
+         return addKernel(r, a, b, n);
+       }
+
+      static Unit subResolve (Unit * r, const Unit * a, const Unit * b,
+         long n)
+       {
+         useArithmeticKernel(ADX);
+         return subKernel(r, a, b, n);
+       }
+
+      static Unit mulResolve (Unit * r, const Unit * a, long n, Unit b)
+       {
+         useArithmeticKernel(ADX);
+         return mulKernel(r, a, n, b);
+       }
+
+      static Unit addMulResolve (Unit * r, const Unit * a, long n, Unit b)
+       {
+         useArithmeticKernel(ADX);
+         return addMulKernel(r, a, n, b);
+       }
+
+
+
+      void andN (Unit * r, const Unit * a, const Unit * b, long n)
+       {
+         Stats::limbs(n);
+         andKernel(r, a, b, n);
+       }
+
+      void iorN (Unit * r, const Unit * a, const Unit * b, long n)
+       {
+         Stats::limbs(n);
+         iorKernel(r, a, b, n);
+       }
+
+      void xorN (Unit * r, const Unit * a, const Unit * b, long n)
+       {
+         Stats::limbs(n);
+         xorKernel(r, a, b, n);
+       }
+
+      void comN (Unit * r, const Unit * a, long n)
+       {
+         Stats::limbs(n);
+         comKernel(r, a, n);
+       }
+
+      Unit addN (Unit * r, const Unit * a, const Unit * b, long n)
+       {
+         Stats::limbs(n);
+         return addKernel(r, a, b, n);
+       }
+
+      Unit subN (Unit * r, const Unit * a, const Unit * b, long n)
+       {
+         Stats::limbs(n);
+         return subKernel(r, a, b, n);
+       }
+
+      Unit add1 (Unit * r, const Unit * a, long n, Unit b)
+       {
+         long i;
+
+         Stats::limbs(n);
+
+         for (i = 0; (i < n) && (b != 0); i++)
+          {
+            r[i] = a[i] + b;
+            b = (r[i] < b) ? 1 : 0;
+          }
+         if ((r != a) && (i < n))
+            std::memcpy(r + i, a + i, (n - i) * sizeof(Unit));
+
+         return b;
+       }
+
+      Unit sub1 (Unit * r, const Unit * a, long n, Unit b)
+       {
+         long i;
+         Unit temp;
+
+         Stats::limbs(n);
+
+         for (i = 0; (i < n) && (b != 0); i++)
+          {
+            temp = a[i];
+            r[i] = temp - b;
+            b = (temp < b) ? 1 : 0;
+          }
+         if ((r != a) && (i < n))
+            std::memcpy(r + i, a + i, (n - i) * sizeof(Unit));
+
+         return b;
+       }
+
+      Unit mul1 (Unit * r, const Unit * a, long n, Unit b)
+       {
+         Stats::limbs(n);
+         return mulKernel(r, a, n, b);
+       }
+
+      Unit addMul1 (Unit * r, const Unit * a, long n, Unit b)
+       {
+         Stats::limbs(n);
+         return addMulKernel(r, a, n, b);
+       }
+
+      void mulBasecase (Unit * r, const Unit * a, long an,
+         const Unit * b, long bn)
+       {
+          // Run along the longer operand, as the kernels like long rows.
+         if (an < bn)
+          {
+            const Unit * t = a; a = b; b = t;
+            long tn = an; an = bn; bn = tn;
+          }
+
+         r[an] = mul1(r, a, an, b[0]);
+         for (long i = 1; i < bn; i++)
+            r[an + i] = addMul1(r + i, a, an, b[i]);
+       }
+
+    } /* namespace Limbs */
+
+ } /* namespace BigInt */
@@ -0,0 +1,113 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+/*
+   Limb kernels.
+
+   These are the loops at the bottom of BitField, over plain arrays of
+   Units, like the lowest level of GMP's mpn layer. Where the processor
+   has something better than the portable loop, the best version it
+   supports is picked the first time a kernel is called. The choice can
+   be overridden, which is mostly useful for benchmarking.
+
+   Unless noted otherwise, the result may be the same array as an operand,
+   but must not otherwise overlap one.
+*/
+
+#ifndef LIMBS_HPP
+#define LIMBS_HPP
+
+#include "BitField.hpp"
+
+namespace BigInt
+ {
+
+   namespace Limbs
+    {
+
+      enum Kernel
+       {
+         PORTABLE,
+         SSE2,
+         AVX2,
+         AVX512,
+         ADX
+       };
+
+      const char * kernelName (Kernel);
+      bool hasKernel (Kernel);
+
+       /*
+         Returns the kernel actually in use, which may be less than asked.
+         The bitwise operations go up to AVX512, the arithmetic is either
+         PORTABLE or ADX (which also needs BMI2 for MULX).
+       */
+      Kernel useBitwiseKernel (Kernel);
+      Kernel bitwiseKernel (void);
+      Kernel useArithmeticKernel (Kernel);
+      Kernel arithmeticKernel (void);
+
+       // r[i] = a[i] op b[i], for 0 <= i < n
+      void andN (Unit * r, const Unit * a, const Unit * b, long n);
+      void iorN (Unit * r, const Unit * a, const Unit * b, long n);
+      void xorN (Unit * r, const Unit * a, const Unit * b, long n);
+
+       // r[i] = ~a[i], for 0 <= i < n
+      void comN (Unit * r, const Unit * a, long n);
+
+       // r = a + b, over n Units, returning the carry out
+      Unit addN (Unit * r, const Unit * a, const Unit * b, long n);
+       // r = a - b, over n Units, returning the borrow out
+      Unit subN (Unit * r, const Unit * a, const Unit * b, long n);
+
+       /*
+         r = a + b and r = a - b for a single Unit b, over n Units,
+         returning the carry/borrow out. These stop as soon as the carry
+         dies, copying the rest of a if r isn't a.
+       */
+      Unit add1 (Unit * r, const Unit * a, long n, Unit b);
+      Unit sub1 (Unit * r, const Unit * a, long n, Unit b);
+
+       // r = a * b, over n Units, returning the high Unit
+      Unit mul1 (Unit * r, const Unit * a, long n, Unit b);
+       // r += a * b, over n Units, returning the high Unit
+      Unit addMul1 (Unit * r, const Unit * a, long n, Unit b);
+
+       /*
+         r = a * b, the schoolbook way. r must have room for an + bn
+         Units, and must not overlap a or b.
+       */
+      void mulBasecase (Unit * r, const Unit * a, long an,
+         const Unit * b, long bn);
+
+    } /* namespace Limbs */
+
+ } /* namespace BigInt */
+
+#endif /* LIMBS_HPP */
@@ -0,0 +1,162 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include "Mapping.hpp"
+
+#if (defined(__unix__) || defined(__APPLE__)) && \
+    defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define MAP_INTEGERS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BigInt
+ {
+
+   static bool readInteger (const char * path, Integer & result,
+      unsigned long long offset)
+    {
+      std::ifstream file (path, std::ios::in | std::ios::binary);
+      Integer temp;
+
+      if (!file.seekg((std::streamoff) offset) || !temp.deserialize(file))
+         return false;
+
+      result = temp;
+      return true;
+    }
+
+#ifdef MAP_INTEGERS
+
+   class Mapping
+    {
+      public:
+         void * Address;
+         size_t Length;
+    };
+
+   static void unmap (void * owner)
+    {
+      Mapping * mapping = (Mapping *) owner;
+
+      munmap(mapping->Address, mapping->Length);
+      delete mapping;
+    }
+
+   bool mapInteger (const char * path, Integer & result,
+      unsigned long long offset)
+    {
+      unsigned char header [16], check [16];
+      unsigned long long units, start, skip;
+      struct stat info;
+      Mapping * mapping;
+      void * address;
+      Unit * data;
+      Integer temp;
+      int file;
+
+      if ((offset % sizeof(Unit)) != 0) return readInteger(path, result, offset);
+
+      file = open(path, O_RDONLY);
+      if (file < 0) return false;
+
+      if ((fstat(file, &info) != 0) ||
+          (pread(file, header, 16, (off_t) offset) != 16))
+       {
+         close(file);
+         return false;
+       }
+
+       // Let Integer check the header, without the Units we haven't read.
+      std::memcpy(check, header, 16);
+      std::memset(check + 8, 0, 8);
+      if (temp.deserialize(check, 16) == 0)
+       {
+         close(file);
+         return false;
+       }
+
+      units = 0;
+      for (int i = 7; i >= 0; i--) units = (units << 8) | header[8 + i];
+
+      if ((units > (unsigned long long) LONG_MAX / sizeof(Unit)) ||
+          (offset + 16 + units * sizeof(Unit) > (unsigned long long) info.st_size))
+       {
+         close(file);
+         return false;
+       }
+
+      if (units == 0) // temp is already zero
+       {
+         close(file);
+         result = temp;
+         return true;
+       }
+
+       // The mapping has to start on a page, so we take a little extra.
+      start = offset + 16;
+      skip = start % (unsigned long long) sysconf(_SC_PAGESIZE);
+
+      address = mmap(NULL, skip + units * sizeof(Unit), PROT_READ | PROT_WRITE,
+         MAP_PRIVATE, file, (off_t) (start - skip));
+      close(file);
+
+      if (address == MAP_FAILED) return readInteger(path, result, offset);
+
+      mapping = new Mapping;
+      mapping->Address = address;
+      mapping->Length = skip + units * sizeof(Unit);
+
+       // Leading zeros are legal, but we don't keep them.
+      data = (Unit *) ((unsigned char *) address + skip);
+      while ((units > 0) && (data[units - 1] == 0)) units--;
+
+      temp.Digits = BitField(data, (long) units, unmap, mapping);
+      temp.Sign = ((header[5] & 1) != 0) && !temp.Digits.isZero();
+
+      result = temp;
+      return true;
+    }
+
+#else
+
+   bool mapInteger (const char * path, Integer & result,
+      unsigned long long offset)
+    {
+      return readInteger(path, result, offset);
+    }
+
+#endif /* MAP_INTEGERS */
+
+ } /* namespace BigInt */
@@ -0,0 +1,62 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+/*
+   Reading Integers straight out of a file.
+
+   mapInteger() reads an Integer that Integer::serialize() wrote to a file,
+   at the given offset, without reading the Units: the file is mapped into
+   memory, and the system pulls the Units in as they are used. This is for
+   numbers that are big enough that reading them is the slow part.
+
+   The mapping is private. Nothing is ever written back to the file: if the
+   Integer is changed in place, the system copies the pages that were
+   written to. Most everything makes a new Integer instead, anyway. The
+   mapping goes away with the last copy of the Integer.
+
+   The Units have to be aligned to map them, so the record has to start at
+   a multiple of eight bytes into the file. If it doesn't, or this machine
+   isn't little-endian, or mapping files isn't something the system does,
+   the Integer is simply read. Returns false, leaving result alone, if there
+   isn't an Integer there.
+*/
+
+#ifndef MAPPING_HPP
+#define MAPPING_HPP
+
+#include "Integer.hpp"
+
+namespace BigInt
+ {
+
+   bool mapInteger (const char *, Integer &, unsigned long long offset = 0);
+
+ } /* namespace BigInt */
+
+#endif /* MAPPING_HPP */
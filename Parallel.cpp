@@ -0,0 +1,209 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "Parallel.hpp"
+#include "Stats.hpp"
+
+namespace BigInt
+ {
+
+   namespace Parallel
+    {
+
+       /*
+         These are meant to be set up before any multiplying starts, and
+         left alone while it happens.
+       */
+      static int Threads = 1;
+      static long Cutoff = 2048;
+
+      static void spawn (void (*job) (void *), void * argument, void *)
+       {
+         std::thread (job, argument).detach();
+       }
+
+      static Executor Run = spawn;
+      static void * Context = NULL;
+
+       // Zero outside of a Task, where the limit is Threads.
+      static thread_local int Budget = 0;
+
+      int getThreads (void) { return Threads; }
+      int setThreads (int threads)
+       {
+         return (Threads = ((threads < 1) ? 1 : threads));
+       }
+
+      void setExecutor (Executor run, void * context)
+       {
+         if (run == NULL)
+          {
+            Run = spawn;
+            Context = NULL;
+          }
+         else
+          {
+            Run = run;
+            Context = context;
+          }
+       }
+
+      long getCutoff (void) { return Cutoff; }
+      long setCutoff (long units) { return (Cutoff = units); }
+
+      int threads (void) { return (Budget != 0) ? Budget : Threads; }
+
+      Limit::Limit (int threads) : Old (Budget) { Budget = threads; }
+      Limit::~Limit () { Budget = Old; }
+
+       /*
+         Whoever claims the work first runs it: the Executor's thread, or
+         the one waiting for it. This is shared by the two of them, and the
+         last one out deletes it.
+       */
+      class Task::Shared
+       {
+         public:
+            void (*Work) (void *);
+            void * Argument;
+            int Threads;
+
+            std::atomic<int> Refs;
+            std::atomic<bool> Claimed;
+
+            std::mutex Lock;
+            std::condition_variable Finished;
+            bool Done;
+
+             // What the work did on another thread, for the waiter to count.
+            Stats::Counters Counted;
+             // And what it threw, for the waiter to throw.
+            std::exception_ptr Error;
+
+            Shared (void (*work) (void *), void * argument, int threads) :
+               Work (work), Argument (argument), Threads (threads),
+               Refs (2), Claimed (false), Done (false) { }
+
+            bool claim (void)
+             {
+               bool expected = false;
+               return Claimed.compare_exchange_strong(expected, true);
+             }
+
+            void run (void)
+             {
+               Limit limit (Threads);
+               Work(Argument);
+             }
+
+            void release (void)
+             {
+               if (--Refs == 0) delete this;
+             }
+       };
+
+      void Task::start (void * shared)
+       {
+         Shared * state = (Shared *) shared;
+
+         if (state->claim())
+          {
+            Stats::Counters saved = Stats::snapshot();
+
+            Stats::reset();
+            try
+             {
+               state->run();
+             }
+            catch (...)
+             {
+               state->Error = std::current_exception();
+             }
+            state->Counted = Stats::snapshot();
+            Stats::reset();
+            Stats::merge(saved);
+
+            std::lock_guard<std::mutex> lock (state->Lock);
+            state->Done = true;
+            state->Finished.notify_all();
+          }
+
+         state->release();
+       }
+
+      Task::Task (void (*work) (void *), void * argument, int threads) :
+         State (new Shared (work, argument, threads)), Waited (false)
+       {
+          // If there's no thread to be had, wait() will do it.
+         try
+          {
+            Run(start, State, Context);
+          }
+         catch (...)
+          {
+            State->Refs--;
+          }
+       }
+
+       // Only reached without a wait() when something else was thrown.
+      Task::~Task ()
+       {
+         try
+          {
+            wait();
+          }
+         catch (...)
+          {
+          }
+         State->release();
+       }
+
+      void Task::wait (void)
+       {
+         if (Waited) return;
+         Waited = true;
+
+         if (State->claim()) State->run();
+         else
+          {
+            std::unique_lock<std::mutex> lock (State->Lock);
+            while (!State->Done) State->Finished.wait(lock);
+            Stats::merge(State->Counted);
+            if (State->Error) std::rethrow_exception(State->Error);
+          }
+       }
+
+    } /* namespace Parallel */
+
+ } /* namespace BigInt */
@@ -0,0 +1,116 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+/*
+   Running big multiplications on more than one thread.
+
+   This is off until setThreads() is given more than one thread. Then a
+   multiplication with both operands at least getCutoff() Units long hands
+   the independent pieces of its Karatsuba step to other threads, and those
+   pieces may do the same, until the threads are used up. Smaller
+   multiplications never notice.
+
+   By default, each piece gets a new std::thread. A program that has its
+   own pool can supply an Executor instead: it must call job(argument)
+   once, on whatever thread it likes, whenever it likes. A piece that
+   hasn't been started by the time its result is needed is run by the
+   thread that needs it, so an Executor that is slow or short of threads
+   only costs parallelism, never deadlock.
+
+   The reference counts in BitField aren't atomic, so every piece is given
+   numbers that nothing else shares. The numbers passed to operator* must
+   not be changed by another thread while it runs, as always.
+*/
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+namespace BigInt
+ {
+
+   namespace Parallel
+    {
+
+      typedef void (*Executor) (void (*job) (void *), void * argument,
+         void * context);
+
+      int getThreads (void);
+      int setThreads (int);
+
+       // NULL goes back to a new std::thread for each piece.
+      void setExecutor (Executor, void * context);
+
+      long getCutoff (void);
+      long setCutoff (long);
+
+       /*
+         For Integer: how many threads this one may use, and a way to lower
+         that while a Limit is around.
+       */
+      int threads (void);
+
+      class Limit
+       {
+         private:
+            int Old;
+
+         public:
+            explicit Limit (int);
+            ~Limit ();
+       };
+
+       /*
+         A piece of work, run with some number of threads. It starts on
+         construction, and wait() returns once it is done, or throws what
+         it threw.
+       */
+      class Task
+       {
+         private:
+            class Shared;
+            Shared * State;
+            bool Waited;
+
+            static void start (void *);
+
+            Task (const Task &);
+            void operator = (const Task &);
+
+         public:
+            Task (void (*) (void *), void *, int threads);
+            ~Task ();
+
+            void wait (void);
+       };
+
+    } /* namespace Parallel */
+
+ } /* namespace BigInt */
+
+#endif /* PARALLEL_HPP */
@@ -0,0 +1,219 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+#include <cmath>
+#include "Sieve.hpp"
+
+namespace BigInt
+ {
+
+    /*
+      Each Unit holds eight groups of thirty numbers, so a segment of 4096
+      Units is 32KB and covers 983040 numbers.
+    */
+   const long PrimeSieve::segmentWords = 4096;
+
+   static const Unit numbers = 240; // per Unit
+   static const Unit limit = ((Unit) -1) - (((Unit) 1) << 40);
+
+   static const Unit residues [8] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+   static const Unit steps [8] = { 6, 4, 2, 4, 2, 4, 6, 2 };
+   static const Unit small [3] = { 2, 3, 5 };
+
+    /*
+      The bit for each residue mod 30, or -1 for those that are divisible
+      by 2, 3, or 5.
+    */
+   static const signed char bitOf [30] =
+    {
+      -1,  0, -1, -1, -1, -1, -1,  1, -1, -1, -1,  2, -1,  3, -1,
+      -1, -1,  4, -1,  5, -1, -1, -1,  6, -1, -1, -1, -1, -1,  7
+    };
+
+   static Unit isqrt (Unit n)
+    {
+      Unit r = (Unit) std::sqrt((double) n);
+      while ((r > 0) && (r > n / r)) r--;
+      while ((r + 1) <= n / (r + 1)) r++;
+      return r;
+    }
+
+
+
+   PrimeSieve::PrimeSieve (Unit from, Unit to) :
+      From (from), To (to), Low (0), High (0), Word (segmentWords), Bits (0),
+      Pending (0), Small (0), Done (false), Segment (segmentWords),
+      Crossers (), Base (NULL)
+    {
+      if (To > limit) To = limit;
+      if (From >= To)
+       {
+         Done = true;
+         Small = 3;
+         return;
+       }
+
+      High = From - From % 30;
+
+       // 49 is the first composite that the wheel doesn't remove.
+      if (To > 49) Base = new PrimeSieve (7, isqrt(To - 1) + 1);
+    }
+
+   PrimeSieve::~PrimeSieve ()
+    {
+      if (Base != NULL) delete Base;
+      Base = NULL;
+    }
+
+
+
+   bool PrimeSieve::nextSegment (void)
+    {
+      Unit n;
+
+      if (Done || (High >= To))
+       {
+         Done = true;
+         return false;
+       }
+
+      Low = High;
+      High = Low + numbers * segmentWords;
+
+      for (long i = 0; i < segmentWords; i++) Segment[i] = 0;
+
+       /*
+         Bring in the primes that start crossing off in this segment.
+         The first multiple of p crossed off is p * k, where k is the
+         first number coprime to 30 that is at least p and puts p * k in
+         this segment.
+       */
+      while (Base != NULL)
+       {
+         if (Pending == 0) Pending = Base->next();
+         if ((Pending == 0) || (Pending * Pending >= High)) break;
+
+         Crosser c;
+         Unit k = (Low + Pending - 1) / Pending;
+
+         if (k < Pending) k = Pending;
+         while (bitOf[k % 30] < 0) k++;
+
+         c.Prime = Pending;
+         c.Next = Pending * k;
+         c.Wheel = bitOf[k % 30];
+         Crossers.push_back(c);
+
+         Pending = 0;
+       }
+
+      for (size_t i = 0; i < Crossers.size(); i++)
+       {
+         Crosser & c = Crossers[i];
+         Unit m = c.Next, off;
+         int w = c.Wheel;
+
+         while (m < High)
+          {
+            off = m - Low;
+            Segment[off / numbers] |= ((Unit) 1) <<
+               ((off % numbers) / 30 * 8 + bitOf[off % 30]);
+            m += c.Prime * steps[w];
+            w = (w + 1) & 7;
+          }
+
+         c.Next = m;
+         c.Wheel = w;
+       }
+
+       // One isn't prime, and neither is anything outside [From, To).
+      if (Low == 0) Segment[0] |= 1;
+      for (n = Low; (n < From) && (n < High); n++)
+         if (bitOf[n % 30] >= 0)
+            Segment[(n - Low) / numbers] |=
+               ((Unit) 1) << (((n - Low) % numbers) / 30 * 8 + bitOf[n % 30]);
+      if (To < High)
+       {
+         for (n = To; (n - Low) % numbers != 0; n++)
+            if (bitOf[n % 30] >= 0)
+               Segment[(n - Low) / numbers] |=
+                  ((Unit) 1) << (((n - Low) % numbers) / 30 * 8 +
+                     bitOf[n % 30]);
+         for (long i = (long) ((n - Low) / numbers); i < segmentWords; i++)
+            Segment[i] = (Unit) -1;
+       }
+
+      return true;
+    }
+
+
+
+   Unit PrimeSieve::next (void)
+    {
+      while (Small < 3)
+       {
+         Unit p = small[Small++];
+         if ((p >= From) && (p < To)) return p;
+       }
+
+      while (Bits == 0)
+       {
+         if (Word == segmentWords)
+          {
+            if (!nextSegment()) return 0;
+            Word = 0;
+          }
+         Bits = ~Segment[Word++];
+       }
+
+      int t = __builtin_ctzll(Bits);
+      Bits &= Bits - 1;
+
+      return Low + (Unit) (Word - 1) * numbers + (Unit) (t / 8) * 30 +
+         residues[t % 8];
+    }
+
+
+
+   Unit primeCount (Unit from, Unit to)
+    {
+      PrimeSieve sieve (from, to);
+      Unit count = 0;
+
+      for (int i = 0; i < 3; i++)
+         if ((small[i] >= sieve.From) && (small[i] < sieve.To)) count++;
+
+      while (sieve.nextSegment())
+         for (long i = 0; i < PrimeSieve::segmentWords; i++)
+            count += 64 - __builtin_popcountll(sieve.Segment[i]);
+
+      return count;
+    }
+
+ } /* namespace BigInt */
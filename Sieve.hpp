@@ -0,0 +1,99 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+/*
+   A segmented sieve of Eratosthenes.
+
+   The sieve only stores numbers coprime to 30: each group of 30 numbers
+   needs eight bits, one for each of 1, 7, 11, 13, 17, 19, 23, and 29.
+   A set bit marks a composite. Segments are kept small enough to stay in
+   the L1 cache, and the primes used for crossing off are themselves read
+   from a smaller PrimeSieve, so nothing grows with the size of the range.
+
+   The range must end below 2^64 - 2^40, which is far beyond anything that
+   can be sieved in practice.
+*/
+
+#ifndef SIEVE_HPP
+#define SIEVE_HPP
+
+#include <vector>
+#include "BitField.hpp"
+
+namespace BigInt
+ {
+
+   class PrimeSieve
+    {
+
+      private:
+         class Crosser
+          {
+            public:
+               Unit Prime;
+               Unit Next; // The next multiple to cross off
+               int Wheel; // Where the cofactor of Next is on the wheel
+          };
+
+         Unit From, To;
+         Unit Low, High; // The current segment is [Low, High)
+         long Word;      // Where next() is in the current segment
+         Unit Bits;
+         Unit Pending;   // A prime from Base, not yet needed
+         int Small;      // The index of the next of 2, 3, and 5
+         bool Done;
+
+         std::vector<Unit> Segment;
+         std::vector<Crosser> Crossers;
+         PrimeSieve * Base;
+
+         bool nextSegment (void);
+
+         PrimeSieve (const PrimeSieve &);
+         void operator = (const PrimeSieve &);
+
+      public:
+         PrimeSieve (Unit from, Unit to); // The primes in [from, to)
+         ~PrimeSieve ();
+
+          // The next prime, in increasing order, or 0 when there are none.
+         Unit next (void);
+
+         static const long segmentWords;
+
+         friend Unit primeCount (Unit, Unit);
+
+    }; /* class PrimeSieve */
+
+    // The number of primes in [from, to)
+   Unit primeCount (Unit from, Unit to);
+
+ } /* namespace BigInt */
+
+#endif /* SIEVE_HPP */
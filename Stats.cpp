@@ -0,0 +1,136 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+#include <cstdio>
+#include "Stats.hpp"
+
+namespace BigInt
+ {
+
+   namespace Stats
+    {
+
+#ifdef BIGINT_STATS
+      thread_local Counters Current;
+#endif
+
+      static const char * const names [ALGORITHMS] =
+       {
+         "multiply_short",
+         "multiply_long",
+         "multiply_karatsuba",
+         "square_karatsuba",
+         "multiply_parallel",
+         "divide_short",
+         "divide_long",
+         "convert_short",
+         "convert_split"
+       };
+
+      const char * algorithmName (Algorithm which)
+       {
+         return ((which >= 0) && (which < ALGORITHMS)) ? names[which] : "unknown";
+       }
+
+      Counters snapshot (void)
+       {
+#ifdef BIGINT_STATS
+         return Current;
+#else
+         Counters result = Counters();
+         return result;
+#endif
+       }
+
+      void reset (void)
+       {
+#ifdef BIGINT_STATS
+         Current = Counters();
+#endif
+       }
+
+      void merge (const Counters & src)
+       {
+#ifdef BIGINT_STATS
+         Current.Allocations += src.Allocations;
+         Current.Bytes += src.Bytes;
+         Current.Detaches += src.Detaches;
+         Current.Limbs += src.Limbs;
+         for (int a = 0; a < ALGORITHMS; a++)
+            for (int b = 0; b < BUCKETS; b++)
+               Current.Calls[a][b] += src.Calls[a][b];
+#else
+         (void) src;
+#endif
+       }
+
+      std::string exportJSON (const Counters & src)
+       {
+         std::string result;
+         char buffer [128];
+         bool firstAlgorithm = true, firstBucket;
+
+         std::snprintf(buffer, sizeof(buffer),
+            "{\"allocations\":%llu,\"bytes\":%llu,\"detaches\":%llu,\"limbs\":%llu,",
+            src.Allocations, src.Bytes, src.Detaches, src.Limbs);
+         result = buffer;
+         result += "\"calls\":{";
+
+         for (int a = 0; a < ALGORITHMS; a++)
+          {
+            firstBucket = true;
+            for (int b = 0; b < BUCKETS; b++)
+             {
+               if (src.Calls[a][b] == 0) continue;
+
+               if (firstBucket)
+                {
+                  if (!firstAlgorithm) result += ",";
+                  result += "\"";
+                  result += names[a];
+                  result += "\":{";
+                  firstAlgorithm = false;
+                }
+               else result += ",";
+               firstBucket = false;
+
+               std::snprintf(buffer, sizeof(buffer), "\"%llu\":%llu",
+                  1ULL << b, src.Calls[a][b]);
+               result += buffer;
+             }
+            if (!firstBucket) result += "}";
+          }
+
+         result += "}}";
+         return result;
+       }
+
+    } /* namespace Stats */
+
+ } /* namespace BigInt */
@@ -0,0 +1,150 @@
+/*
+Copyright (c) 2010, 2011 Thomas DiModica.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. Neither the name of Thomas DiModica nor the names of other contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THOMAS DIMODICA AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED.  IN NO EVENT SHALL THOMAS DIMODICA OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+SUCH DAMAGE.
+*/
+
+/*
+   Counting what the library does, for finding out why something is slow.
+
+   This is compiled in only if BIGINT_STATS is defined, and then it must be
+   defined for every file, including the library's. Otherwise the counting
+   calls are empty and snapshot() is always zero.
+
+   The counts are per thread: snapshot() and reset() see only the calling
+   thread's. A multiplication that hands pieces to other threads (see
+   Parallel.hpp) gets their counts added back to its own when it waits
+   for them, so they aren't lost.
+
+   What's counted:
+      Allocations, Bytes   Unit arrays new []'d by BitField, and their size
+      Detaches             times a shared BitHolder was copied to change it
+      Limbs                Units run through the kernels in Limbs.hpp
+      Calls                which algorithm ran, by the size of its operands
+*/
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <string>
+
+namespace BigInt
+ {
+
+   namespace Stats
+    {
+
+      enum Algorithm
+       {
+         MULTIPLY_SHORT,      // by a single Unit
+         MULTIPLY_LONG,       // schoolbook
+         MULTIPLY_KARATSUBA,
+         SQUARE_KARATSUBA,
+         MULTIPLY_PARALLEL,   // one of those Karatsuba steps, split up
+         DIVIDE_SHORT,        // by a single Unit
+         DIVIDE_LONG,         // Knuth's algorithm D
+         CONVERT_SHORT,       // radix conversion, a piece at a time
+         CONVERT_SPLIT,       // radix conversion, divide and conquer step
+         ALGORITHMS
+       };
+
+       /*
+         Calls[a][b] counts algorithm a on operands with 2^b to 2^(b+1) - 1
+         Units (the longer one, if there are two). The last bucket takes
+         everything bigger.
+       */
+      const int BUCKETS = 32;
+
+      class Counters
+       {
+         public:
+            unsigned long long Allocations;
+            unsigned long long Bytes;
+            unsigned long long Detaches;
+            unsigned long long Limbs;
+            unsigned long long Calls [ALGORITHMS][BUCKETS];
+       };
+
+      inline bool enabled (void)
+       {
+#ifdef BIGINT_STATS
+         return true;
+#else
+         return false;
+#endif
+       }
+
+      const char * algorithmName (Algorithm);
+
+      Counters snapshot (void);
+      void reset (void);
+      void merge (const Counters &);
+
+       /*
+         As one line of JSON, leaving out the algorithms that never ran:
+         {"allocations":1,"bytes":8,"detaches":0,"limbs":2,
+          "calls":{"multiply_long":{"1":1}}}
+         where the keys of each algorithm are the bottoms of its buckets.
+       */
+      std::string exportJSON (const Counters &);
+
+#ifdef BIGINT_STATS
+
+      extern thread_local Counters Current;
+
+      inline void allocated (unsigned long long bytes)
+       {
+         Current.Allocations++;
+         Current.Bytes += bytes;
+       }
+
+      inline void detached (void) { Current.Detaches++; }
+
+      inline void limbs (long count) { Current.Limbs += count; }
+
+      inline void chose (Algorithm which, long units)
+       {
+         int bucket = 0;
+
+         while ((bucket < BUCKETS - 1) && ((units >> (bucket + 1)) != 0))
+            bucket++;
+         Current.Calls[which][bucket]++;
+       }
+
+#else
+
+      inline void allocated (unsigned long long) { }
+      inline void detached (void) { }
+      inline void limbs (long) { }
+      inline void chose (Algorithm, long) { }
+
+#endif
+
+    } /* namespace Stats */
+
+ } /* namespace BigInt */
+
+#endif /* STATS_HPP */